@@ -0,0 +1,664 @@
+#include <benchmark/benchmark.h>
+#include <UpmixRT/AlignedBuffer.h>
+#include <UpmixRT/AmbisonicDecoder.h>
+#include <UpmixRT/AmbisonicEncoder.h>
+#include <UpmixRT/AnalysisBand.h>
+#include <UpmixRT/BiquadBank.h>
+#include <UpmixRT/Decorrelator.h>
+#include <UpmixRT/FilterBank.h>
+#include <UpmixRT/OutputWriter.h>
+#include <UpmixRT/SimdKernels.h>
+#include <UpmixRT/SpatialAnalyzer.h>
+#include <UpmixRT/SpeakerLayout.h>
+#include <UpmixRT/UpmixPipeline.h>
+#include <UpmixRT/VelvetDecorrelator.h>
+#include <cstdint>
+#include <vector>
+
+// Per-stage microbenchmarks of the DSP chain. Every benchmark processes
+// kBenchBlockSize samples per iteration and reports the "time/sample" counter:
+// wall time per stereo input sample frame, printed as e.g. "12.3ns".
+
+using namespace audio_plugin;
+
+namespace {
+
+constexpr double kBenchSampleRate = 48000.0;
+
+// Shorter than a layout crossfade at kBenchSampleRate (960 samples), so the
+// crossfade benchmarks never leave the crossfade.
+constexpr int kBenchBlockSize = 512;
+
+// Partially correlated stereo noise, so the analysis sees realistic ICC and
+// azimuth values rather than silence or a mono signal.
+struct StereoInput {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+const StereoInput& benchInput() {
+    static const StereoInput input = [] {
+        StereoInput in;
+        in.left.resize(kBenchBlockSize);
+        in.right.resize(kBenchBlockSize);
+        uint32_t seed = 12345;
+        auto noise = [&seed] {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        };
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            float common = noise();
+            in.left[static_cast<size_t>(i)] = 0.5f * common + 0.2f * noise();
+            in.right[static_cast<size_t>(i)] = 0.4f * common + 0.2f * noise();
+        }
+        return in;
+    }();
+    return input;
+}
+
+// Per-sample spatial parameters for the encoder benchmarks.
+const std::vector<SpatialParams>& benchParams() {
+    static const std::vector<SpatialParams> params = [] {
+        const auto& in = benchInput();
+        std::vector<SpatialParams> p(kBenchBlockSize);
+        SpatialAnalyzer analyzer;
+        analyzer.prepare(kBenchSampleRate);
+        analyzer.processBlock(in.left.data(), in.right.data(), kBenchBlockSize, p.data());
+        return p;
+    }();
+    return params;
+}
+
+// Reports the mean wall time per processed sample (inverted sample rate, so
+// the console reporter prints it in seconds with an SI prefix).
+void setTimePerSample(benchmark::State& state) {
+    state.SetItemsProcessed(state.iterations() * kBenchBlockSize);
+    state.counters["time/sample"] = benchmark::Counter(
+        kBenchBlockSize,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+SpeakerLayout layoutArg(const benchmark::State& state) {
+    return static_cast<SpeakerLayout>(state.range(0));
+}
+
+// Layout crossfaded from in the decoder crossfade benchmarks: the largest
+// layout other than the target, so both matrices are as wide as possible.
+SpeakerLayout crossfadeSource(SpeakerLayout target) {
+    return target == SpeakerLayout::Surround222 ? SpeakerLayout::Surround916
+                                                : SpeakerLayout::Surround222;
+}
+
+void applyLayoutArgs(benchmark::internal::Benchmark* b) {
+    for (int i = 0; i < static_cast<int>(SpeakerLayout::kNumLayouts); ++i)
+        b->Arg(i);
+    b->ArgName("layout");
+}
+
+// ===== Biquad =====
+
+// One filter over a block, the case with no channels to fill SIMD lanes.
+// Arg: 0 = recursive (BiquadBank<1>), 1 = block form (BlockBiquadBank<1>).
+void BM_BiquadProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    auto coeffs = BiquadCoefficients::makeLowPass(kBenchSampleRate, kCrossoverFreqs[0], 0.5f);
+    BiquadBank<1> recursive;
+    BlockBiquadBank<1> block;
+    recursive.setCoefficients(coeffs);
+    block.setCoefficients(0, coeffs);
+    std::vector<float> output(kBenchBlockSize);
+    float* outputs[1] = {output.data()};
+
+    for (auto _ : state) {
+        if (state.range(0) == 0)
+            recursive.processBlock(in.left.data(), output.data(), kBenchBlockSize);
+        else
+            block.processBlock(in.left.data(), outputs, kBenchBlockSize);
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_BiquadProcessBlock)->ArgName("form")->Arg(0)->Arg(1);
+
+// ===== FilterBank =====
+
+void BM_FilterBankProcess(benchmark::State& state) {
+    const auto& in = benchInput();
+    FilterBank filterBank;
+    filterBank.prepare(kBenchSampleRate);
+    float bandL[kNumBands];
+    float bandR[kNumBands];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            filterBank.process(in.left[static_cast<size_t>(i)], in.right[static_cast<size_t>(i)],
+                               bandL, bandR);
+            benchmark::DoNotOptimize(bandL);
+            benchmark::DoNotOptimize(bandR);
+        }
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_FilterBankProcess);
+
+// Arg: FilterBankTopology (0 = cascade, 1 = parallel, 2 = time-parallel cascade).
+void BM_FilterBankProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    FilterBank filterBank;
+    filterBank.prepare(kBenchSampleRate, static_cast<FilterBankTopology>(state.range(0)));
+    AlignedBuffer bands;
+    bands.allocate(2 * kNumBands, kBenchBlockSize);
+    auto* const* ptrs = bands.getArrayOfChannels();
+
+    for (auto _ : state) {
+        filterBank.processBlock(in.left.data(), in.right.data(), kBenchBlockSize,
+                                ptrs, ptrs + kNumBands);
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_FilterBankProcessBlock)->ArgName("topology")->DenseRange(0, 2);
+
+// ===== AnalysisBand =====
+
+void BM_AnalysisBandProcess(benchmark::State& state) {
+    const auto& in = benchInput();
+    AnalysisBand band;
+    band.prepare(kBenchSampleRate);
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            auto result = band.process(in.left[static_cast<size_t>(i)], in.right[static_cast<size_t>(i)]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AnalysisBandProcess);
+
+// ===== SpatialAnalyzer =====
+
+void BM_SpatialAnalyzerProcess(benchmark::State& state) {
+    const auto& in = benchInput();
+    SpatialAnalyzer analyzer;
+    analyzer.prepare(kBenchSampleRate);
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            auto params = analyzer.process(in.left[static_cast<size_t>(i)], in.right[static_cast<size_t>(i)]);
+            benchmark::DoNotOptimize(params);
+        }
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_SpatialAnalyzerProcess);
+
+// Arg: control interval (1 = per-sample reference).
+void BM_SpatialAnalyzerProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    SpatialAnalyzer analyzer;
+    AnalysisConfig config;
+    config.controlInterval = static_cast<int>(state.range(0));
+    analyzer.prepare(kBenchSampleRate, config);
+    std::vector<SpatialParams> params(kBenchBlockSize);
+
+    for (auto _ : state) {
+        analyzer.processBlock(in.left.data(), in.right.data(), kBenchBlockSize, params.data());
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_SpatialAnalyzerProcessBlock)->ArgName("interval")->Arg(1)->Arg(16)->Arg(32);
+
+// Host rate in kHz, and full-rate or multirate analysis. "load" is the wall
+// time per second of audio at that rate, so the rates compare directly.
+void BM_SpatialAnalyzerProcessBlockRate(benchmark::State& state) {
+    const auto& in = benchInput();
+    const double sampleRate = 1000.0 * static_cast<double>(state.range(0));
+    SpatialAnalyzer analyzer;
+    AnalysisConfig config;
+    config.filterBankTopology = FilterBankTopology::Parallel;
+    config.multirate = state.range(1) != 0;
+    analyzer.prepare(sampleRate, config);
+    std::vector<SpatialParams> params(kBenchBlockSize);
+
+    for (auto _ : state) {
+        analyzer.processBlock(in.left.data(), in.right.data(), kBenchBlockSize, params.data());
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+    state.counters["load"] = benchmark::Counter(
+        kBenchBlockSize / sampleRate,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_SpatialAnalyzerProcessBlockRate)
+    ->ArgNames({"kHz", "multirate"})
+    ->ArgsProduct({{48, 96, 192}, {0, 1}});
+
+// STFT engine; Args: number of bands, and 0 = Bark or 1 = ERB spacing.
+// Compare with BM_SpatialAnalyzerProcessBlock (the 8 IIR bands).
+void BM_SpatialAnalyzerProcessBlockStft(benchmark::State& state) {
+    const auto& in = benchInput();
+    SpatialAnalyzer analyzer;
+    AnalysisConfig config;
+    config.engine = AnalysisEngine::Stft;
+    config.stftNumBands = static_cast<int>(state.range(0));
+    config.stftBandScale = static_cast<BandScale>(state.range(1));
+    analyzer.prepare(kBenchSampleRate, config);
+    std::vector<SpatialParams> params(kBenchBlockSize);
+
+    for (auto _ : state) {
+        analyzer.processBlock(in.left.data(), in.right.data(), kBenchBlockSize, params.data());
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_SpatialAnalyzerProcessBlockStft)
+    ->ArgNames({"bands", "erb"})
+    ->ArgsProduct({{8, 24, 32, 64}, {0, 1}});
+
+// ===== Decorrelator =====
+
+void BM_DecorrelatorProcess(benchmark::State& state) {
+    const auto& in = benchInput();
+    Decorrelator decorrelator;
+    decorrelator.prepare(kBenchSampleRate, kDecorrDelaysZ, 2);
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            float out = decorrelator.process(in.left[static_cast<size_t>(i)]);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_DecorrelatorProcess);
+
+void BM_DecorrelatorProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    Decorrelator decorrelator;
+    decorrelator.prepare(kBenchSampleRate, kDecorrDelaysZ, 2);
+    std::vector<float> out(kBenchBlockSize);
+
+    for (auto _ : state) {
+        decorrelator.processBlock(in.left.data(), out.data(), kBenchBlockSize);
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_DecorrelatorProcessBlock);
+
+// X and Z lanes together, as the encoder runs them
+void BM_DecorrelatorPairProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    DecorrelatorPair decorrelator;
+    decorrelator.prepare(kBenchSampleRate, kDecorrDelaysX, kDecorrDelaysZ,
+                         static_cast<int>(state.range(0)));
+    std::vector<float> outX(kBenchBlockSize), outZ(kBenchBlockSize);
+
+    for (auto _ : state) {
+        decorrelator.processBlock(in.left.data(), outX.data(), outZ.data(), kBenchBlockSize);
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_DecorrelatorPairProcessBlock)->ArgName("stages")->Arg(kDefaultDecorrStages)->Arg(kMaxDecorrStages);
+
+// 24 speaker feeds (22.2), one velvet decorrelator each, per VelvetBudget
+void BM_VelvetDecorrelatorBankProcessBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    constexpr int numChannels = 24;
+    const auto budget = static_cast<VelvetBudget>(state.range(0));
+    VelvetDecorrelatorBank bank;
+    bank.prepare(kBenchSampleRate, kBenchBlockSize, numChannels,
+                 kVelvetTapsPerChannel[static_cast<int>(budget)]);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numChannels, kBenchBlockSize);
+    std::vector<float> weights(numChannels, 0.5f);
+
+    for (auto _ : state) {
+        bank.processBlock(in.left.data(), kBenchBlockSize, outputs.getArrayOfChannels(),
+                          numChannels, weights.data(), weights.data());
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_VelvetDecorrelatorBankProcessBlock)->ArgName("budget")->DenseRange(1, 3);
+
+// ===== AmbisonicEncoder =====
+
+void BM_AmbisonicEncoderEncode(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto& params = benchParams();
+    AmbisonicEncoder encoder;
+    encoder.prepare(kBenchSampleRate);
+    float bFormat[kNumAmbiChannels];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            auto s = static_cast<size_t>(i);
+            encoder.encode(in.left[s], in.right[s], params[s], bFormat);
+            benchmark::DoNotOptimize(bFormat);
+        }
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicEncoderEncode);
+
+void BM_AmbisonicEncoderEncodeBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto& params = benchParams();
+    AmbisonicEncoder encoder;
+    encoder.prepare(kBenchSampleRate);
+    AlignedBuffer bFormat;
+    bFormat.allocate(kNumAmbiChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        encoder.encodeBlock(in.left.data(), in.right.data(), params.data(), kBenchBlockSize,
+                            bFormat.getArrayOfChannels());
+        benchmark::ClobberMemory();
+    }
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicEncoderEncodeBlock);
+
+// ===== AmbisonicDecoder =====
+
+// B-format input for the decoder benchmarks, one frame per sample.
+AlignedBuffer makeBFormat() {
+    const auto& in = benchInput();
+    const auto& params = benchParams();
+    AmbisonicEncoder encoder;
+    encoder.prepare(kBenchSampleRate);
+    AlignedBuffer bFormat;
+    bFormat.allocate(kNumAmbiChannels, kBenchBlockSize);
+    encoder.encodeBlock(in.left.data(), in.right.data(), params.data(), kBenchBlockSize,
+                        bFormat.getArrayOfChannels());
+    return bFormat;
+}
+
+void BM_AmbisonicDecoderDecode(benchmark::State& state) {
+    const auto layout = layoutArg(state);
+    const auto bFormat = makeBFormat();
+    AmbisonicDecoder decoder;
+    decoder.prepare(kBenchSampleRate, layout);
+    float frame[kNumAmbiChannels];
+    float speakers[kMaxOutputChannels];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+                frame[ch] = bFormat.getChannel(ch)[i];
+            decoder.decode(frame, layout, speakers);
+            benchmark::DoNotOptimize(speakers);
+        }
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicDecoderDecode)->Apply(applyLayoutArgs);
+
+// Every iteration restarts the crossfade from crossfadeSource(layout): one
+// sample decoded on the source layout, then the block on the target layout.
+void BM_AmbisonicDecoderDecodeCrossfade(benchmark::State& state) {
+    const auto layout = layoutArg(state);
+    const auto source = crossfadeSource(layout);
+    const auto bFormat = makeBFormat();
+    AmbisonicDecoder decoder;
+    decoder.prepare(kBenchSampleRate, layout);
+    float frame[kNumAmbiChannels];
+    float speakers[kMaxOutputChannels];
+
+    for (auto _ : state) {
+        for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+            frame[ch] = bFormat.getChannel(ch)[0];
+        decoder.decode(frame, source, speakers);
+
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+                frame[ch] = bFormat.getChannel(ch)[i];
+            decoder.decode(frame, layout, speakers);
+            benchmark::DoNotOptimize(speakers);
+        }
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicDecoderDecodeCrossfade)->Apply(applyLayoutArgs);
+
+void BM_AmbisonicDecoderDecodeBlock(benchmark::State& state) {
+    const auto layout = layoutArg(state);
+    const int numChannels = getLayoutInfo(layout).numChannels;
+    const auto bFormat = makeBFormat();
+    AmbisonicDecoder decoder;
+    decoder.prepare(kBenchSampleRate, layout);
+    AlignedBuffer speakers;
+    speakers.allocate(numChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        decoder.decodeBlock(bFormat.getArrayOfChannels(), kBenchBlockSize, layout,
+                            speakers.getArrayOfChannels(), numChannels);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicDecoderDecodeBlock)->Apply(applyLayoutArgs);
+
+// Block version of the crossfade benchmark: one sample on the source layout,
+// then the block on the target layout, all inside the crossfade.
+void BM_AmbisonicDecoderDecodeBlockCrossfade(benchmark::State& state) {
+    const auto layout = layoutArg(state);
+    const auto source = crossfadeSource(layout);
+    const auto bFormat = makeBFormat();
+    AmbisonicDecoder decoder;
+    decoder.prepare(kBenchSampleRate, layout);
+    AlignedBuffer speakers;
+    speakers.allocate(kMaxOutputChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        decoder.decodeBlock(bFormat.getArrayOfChannels(), 1, source,
+                            speakers.getArrayOfChannels(), kMaxOutputChannels);
+        decoder.decodeBlock(bFormat.getArrayOfChannels(), kBenchBlockSize, layout,
+                            speakers.getArrayOfChannels(), kMaxOutputChannels);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_AmbisonicDecoderDecodeBlockCrossfade)->Apply(applyLayoutArgs);
+
+// ===== OutputWriter =====
+
+// Dry/wet and gain targets differ from the settled values, so the smoothers
+// keep moving: every iteration alternates between two target pairs.
+void BM_OutputWriterWriteSample(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto layout = layoutArg(state);
+    const int numOutputChannels = 2 + getLayoutInfo(layout).numChannels;
+    OutputWriter writer;
+    writer.prepare(kBenchSampleRate);
+
+    float speakers[kMaxOutputChannels];
+    for (int ch = 0; ch < kMaxOutputChannels; ++ch)
+        speakers[ch] = 0.01f * static_cast<float>(ch + 1);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+    std::vector<float*> outputPtrs(outputs.getArrayOfChannels(),
+                                   outputs.getArrayOfChannels() + numOutputChannels);
+    bool toggle = false;
+
+    for (auto _ : state) {
+        float dryWet = toggle ? 0.25f : 1.0f;
+        float gainDb = toggle ? -12.0f : 0.0f;
+        toggle = !toggle;
+        for (int i = 0; i < kBenchBlockSize; ++i) {
+            auto s = static_cast<size_t>(i);
+            writer.writeSample(speakers, in.left[s], in.right[s], dryWet, gainDb,
+                               numOutputChannels, outputPtrs.data(), i);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_OutputWriterWriteSample)->Apply(applyLayoutArgs);
+
+void BM_OutputWriterWriteBlock(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto layout = layoutArg(state);
+    const int numSpeakers = getLayoutInfo(layout).numChannels;
+    const int numOutputChannels = 2 + numSpeakers;
+    OutputWriter writer;
+    writer.prepare(kBenchSampleRate);
+
+    AlignedBuffer speakers;
+    speakers.allocate(numSpeakers, kBenchBlockSize);
+    for (int ch = 0; ch < numSpeakers; ++ch)
+        for (int i = 0; i < kBenchBlockSize; ++i)
+            speakers.getChannel(ch)[i] = 0.01f * static_cast<float>(ch + 1);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+    bool toggle = false;
+
+    for (auto _ : state) {
+        float dryWet = toggle ? 0.25f : 1.0f;
+        float gainDb = toggle ? -12.0f : 0.0f;
+        toggle = !toggle;
+        writer.writeBlock(speakers.getArrayOfChannels(), in.left.data(), in.right.data(),
+                          kBenchBlockSize, dryWet, gainDb, numOutputChannels,
+                          outputs.getArrayOfChannels());
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_OutputWriterWriteBlock)->Apply(applyLayoutArgs);
+
+// Parameters held constant: after the first iterations both smoothers have
+// settled and every segment is a single constant multiply.
+void BM_OutputWriterWriteBlockSettled(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto layout = layoutArg(state);
+    const int numSpeakers = getLayoutInfo(layout).numChannels;
+    const int numOutputChannels = 2 + numSpeakers;
+    OutputWriter writer;
+    writer.prepare(kBenchSampleRate);
+
+    AlignedBuffer speakers;
+    speakers.allocate(numSpeakers, kBenchBlockSize);
+    for (int ch = 0; ch < numSpeakers; ++ch)
+        for (int i = 0; i < kBenchBlockSize; ++i)
+            speakers.getChannel(ch)[i] = 0.01f * static_cast<float>(ch + 1);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        writer.writeBlock(speakers.getArrayOfChannels(), in.left.data(), in.right.data(),
+                          kBenchBlockSize, 0.8f, -6.0f, numOutputChannels,
+                          outputs.getArrayOfChannels());
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_OutputWriterWriteBlockSettled)->Apply(applyLayoutArgs);
+
+// ===== Full chain =====
+
+void BM_UpmixPipelineProcess(benchmark::State& state) {
+    const auto& in = benchInput();
+    const auto layout = layoutArg(state);
+    const int numOutputChannels = 2 + getLayoutInfo(layout).numChannels;
+    UpmixPipeline pipeline;
+    pipeline.prepare(kBenchSampleRate, kBenchBlockSize, layout);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        pipeline.process(in.left.data(), in.right.data(), outputs.getArrayOfChannels(),
+                         numOutputChannels, kBenchBlockSize, layout, 1.0f, 0.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getLayoutInfo(layout).name);
+    setTimePerSample(state);
+}
+BENCHMARK(BM_UpmixPipelineProcess)->Apply(applyLayoutArgs);
+
+// 22.2 with only the first four aux pairs enabled: eight routed wet feeds
+void BM_UpmixPipelineProcessPartialRouting(benchmark::State& state) {
+    const auto& in = benchInput();
+    constexpr int numWetChannels = 8;
+    const int wetSpeakers[numWetChannels] = {0, 1, 2, 3, 4, 5, 6, 7};
+    UpmixPipeline pipeline;
+    pipeline.prepare(kBenchSampleRate, kBenchBlockSize, SpeakerLayout::Surround222);
+    pipeline.setOutputRouting(wetSpeakers, numWetChannels);
+
+    AlignedBuffer outputs;
+    outputs.allocate(2 + numWetChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        pipeline.process(in.left.data(), in.right.data(), outputs.getArrayOfChannels(),
+                         2 + numWetChannels, kBenchBlockSize, SpeakerLayout::Surround222, 1.0f, 0.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel("22.2, 4 aux pairs");
+    setTimePerSample(state);
+}
+BENCHMARK(BM_UpmixPipelineProcessPartialRouting);
+
+// 22.2 with per-speaker velvet decorrelation of the diffuse signal
+void BM_UpmixPipelineProcessVelvet(benchmark::State& state) {
+    const auto& in = benchInput();
+    const int numOutputChannels = 2 + getLayoutInfo(SpeakerLayout::Surround222).numChannels;
+    const auto budget = static_cast<VelvetBudget>(state.range(0));
+    UpmixPipeline pipeline;
+    pipeline.prepare(kBenchSampleRate, kBenchBlockSize, SpeakerLayout::Surround222, {}, budget);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        pipeline.process(in.left.data(), in.right.data(), outputs.getArrayOfChannels(),
+                         numOutputChannels, kBenchBlockSize, SpeakerLayout::Surround222, 1.0f, 0.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel("22.2");
+    setTimePerSample(state);
+}
+BENCHMARK(BM_UpmixPipelineProcessVelvet)->ArgName("budget")->DenseRange(0, 3);
+
+// 22.2 on each kernel instruction set; levels this CPU lacks are skipped
+void BM_UpmixPipelineProcessSimdLevel(benchmark::State& state) {
+    const auto& in = benchInput();
+    const int numOutputChannels = 2 + getLayoutInfo(SpeakerLayout::Surround222).numChannels;
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    if (!isSimdLevelAvailable(level)) {
+        state.SkipWithError("instruction set not available");
+        return;
+    }
+    UpmixPipeline pipeline;
+    pipeline.prepare(kBenchSampleRate, kBenchBlockSize, SpeakerLayout::Surround222, {},
+                     VelvetBudget::Off, level);
+
+    AlignedBuffer outputs;
+    outputs.allocate(numOutputChannels, kBenchBlockSize);
+
+    for (auto _ : state) {
+        pipeline.process(in.left.data(), in.right.data(), outputs.getArrayOfChannels(),
+                         numOutputChannels, kBenchBlockSize, SpeakerLayout::Surround222, 1.0f, 0.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(getSimdLevelName(level));
+    setTimePerSample(state);
+}
+BENCHMARK(BM_UpmixPipelineProcessSimdLevel)->ArgName("level")->DenseRange(0, kNumSimdLevels - 1);
+
+}  // namespace
+
+BENCHMARK_MAIN();
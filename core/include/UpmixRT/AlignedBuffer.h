@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace audio_plugin {
+
+// Multichannel float scratch storage for block processing.
+// Every channel starts on a kAlignment-byte boundary so block stages can use
+// aligned vector loads. Allocation only happens in allocate(); all other
+// methods are real-time safe.
+class AlignedBuffer {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    void allocate(int numChannels, int numSamples);
+    void clear();
+
+    float* getChannel(int channel);
+    const float* getChannel(int channel) const;
+    float* const* getArrayOfChannels();
+    const float* const* getArrayOfChannels() const;
+
+    int getNumChannels() const { return numChannels_; }
+    int getNumSamples() const { return numSamples_; }
+
+private:
+    std::vector<float> storage_;
+    std::vector<float*> channelPtrs_;
+    size_t stride_ = 0;
+    int numChannels_ = 0;
+    int numSamples_ = 0;
+};
+
+}  // namespace audio_plugin
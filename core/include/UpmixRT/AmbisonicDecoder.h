@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include "BiquadBank.h"
+#include "Constants.h"
+#include "SimdKernels.h"
+#include "SpeakerLayout.h"
+
+namespace audio_plugin {
+
+// Steady-state decoding runs a kernel specialised per SpeakerLayout at compile
+// time from its constexpr matrix (zero terms removed, rows unrolled), built
+// per instruction set (SimdKernels).
+// A layout change crossfades by interpolating one matrix with a fifth, LFE
+// column (W, X, Y, Z, lowpassed W) from the outgoing to the incoming layout,
+// updated every kLayoutCrossfadeUpdateInterval samples, so each sample still
+// costs a single decode pass.
+class AmbisonicDecoder {
+public:
+    void prepare(double sampleRate, SpeakerLayout layout,
+                 const SimdKernels& kernels = getSimdKernels());
+    void reset();
+
+    // Decode B-format to speaker feeds.
+    // bFormat[4] = {W, X, Y, Z}
+    // speakerOutputs: at least kMaxOutputChannels floats
+    void decode(const float* bFormat, SpeakerLayout layout,
+                float* speakerOutputs);
+
+    // Block version of decode().
+    // bFormat[ch] points to numSamples floats for each of W, X, Y, Z.
+    // speakerOutputs[spk] points to numSamples floats for each of the first
+    // numSpeakerOutputs speaker feeds; channels beyond the layout are zeroed.
+    // A null speakerOutputs[spk] marks an unrouted feed, which is skipped.
+    // wetGain, if given, holds numSamples multipliers applied to every feed,
+    // so the feeds can be written straight to their final outputs.
+    void decodeBlock(const float* const* bFormat, int numSamples,
+                     SpeakerLayout layout,
+                     float* const* speakerOutputs, int numSpeakerOutputs,
+                     const float* wetGain = nullptr);
+
+    // Gain of the X/Z part of each of the first numSpeakers feeds in the
+    // matrix playing right now (mid-crossfade included): the norm of the X
+    // and Z terms of its row, 0 past the layout. Scales per-speaker
+    // decorrelated diffuse signal to the level X/Z diffuse would reach.
+    void getDiffuseWeights(float* weights, int numSpeakers) const;
+
+    // Samples for the LFE filter tail to decay below threshold once the
+    // B-format input goes silent (the matrix itself has no memory).
+    int getTailSamples(float threshold) const {
+        return lfeFilter_.getTailSamples(threshold);
+    }
+
+private:
+    // Matrix columns: W, X, Y, Z, then the lowpassed W feed for the LFE
+    static constexpr int kNumColumns = kNumAmbiChannels + 1;
+    static constexpr int kLfeColumn = kNumAmbiChannels;
+    using Matrix = std::array<float, kMaxOutputChannels * kNumColumns>;
+
+    void updateLayout(SpeakerLayout layout);
+    void beginCrossfade(SpeakerLayout layout);
+    void updateFadeMatrix();
+    bool isCrossfading() const { return crossfadePosition_ < crossfadeLength_; }
+
+    SpeakerLayout currentLayout_ = SpeakerLayout::Surround51;
+    const SimdKernels* kernels_ = &getSimdKernels();
+
+    // Layout facts cached by updateLayout(), so decoding never looks them up
+    int numChannels_ = 0;
+
+    // Crossfade: fadeMatrix_ moves from startMatrix_ (what was playing when
+    // the layout changed) to targetMatrix_ (the current layout) over
+    // crossfadeLength_ samples. Rows from fadeNumChannels_ on are zero in both.
+    Matrix targetMatrix_{};
+    Matrix startMatrix_{};
+    Matrix fadeMatrix_{};
+    int fadeNumChannels_ = 0;
+    int crossfadeLength_ = 1;
+    int crossfadePosition_ = 1;  // >= crossfadeLength_: steady state
+
+    // LFE lowpass filter (2nd-order Butterworth)
+    BiquadBank<1> lfeFilter_;
+    int lfeChannelIndex_ = -1;
+    double sampleRate_ = 48000.0;
+};
+
+}  // namespace audio_plugin
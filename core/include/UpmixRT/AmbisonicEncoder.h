@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Constants.h"
+#include "Decorrelator.h"
+
+namespace audio_plugin {
+
+class AmbisonicEncoder {
+public:
+    // decorrelatorStages: allpass stages per diffuse lane, clamped to
+    // [1, kMaxDecorrStages]
+    void prepare(double sampleRate, int decorrelatorStages = kDefaultDecorrStages);
+    void reset();
+
+    // Encode a stereo sample pair into first-order B-format.
+    // bFormat[4] = {W, X, Y, Z}
+    void encode(float inputL, float inputR,
+                const SpatialParams& params,
+                float* bFormat);
+
+    // Block version of encode(). params[s] drives sample s;
+    // bFormat[ch] points to numSamples floats for each of W, X, Y, Z.
+    // If diffuseOut is given, the diffuse feed (before decorrelation, at the
+    // level X and Z would carry it) goes there instead and X/Z get only
+    // their direct parts, for per-speaker decorrelation after decoding.
+    void encodeBlock(const float* inputL, const float* inputR,
+                     const SpatialParams* params, int numSamples,
+                     float* const* bFormat, float* diffuseOut = nullptr);
+
+    // Samples for the decorrelated X/Z tails to decay below threshold once
+    // the input goes silent (W and Y have no memory). Valid after prepare().
+    int getTailSamples(float threshold) const;
+
+private:
+    DecorrelatorPair decorrXZ_;  // lane A feeds X, lane B feeds Z
+};
+
+}  // namespace audio_plugin
@@ -4,6 +4,12 @@
 
 namespace audio_plugin {
 
+// Coefficient of a one-pole smoother with time constant timeSec, advanced
+// `steps` samples per update (1, i.e. no smoothing, when timeSec <= 0).
+// Shared by the band analysers so they all smooth alike.
+float smoothingAlpha(double sampleRate, float timeSec, int steps = 1);
+
+// Per-sample analysis of one band; the scalar reference for AnalysisBank.
 class AnalysisBand {
 public:
     void prepare(double sampleRate);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Constants.h"
+#include "SimdKernels.h"
+
+namespace audio_plugin {
+
+// Smoothers and coefficients of an AnalysisBank, lane = band; stepped by
+// the SimdKernels analysis kernels.
+struct AnalysisBankState {
+    alignas(32) float iccSmooth[kNumBands] = {};
+    alignas(32) float azimuthSmooth[kNumBands] = {};
+    alignas(32) float energySmooth[kNumBands] = {};
+    alignas(32) float smoothLL[kNumBands] = {};
+    alignas(32) float smoothRR[kNumBands] = {};
+    alignas(32) float smoothLR[kNumBands] = {};
+    alignas(32) float azimuthSum[kNumBands] = {};
+
+    // EMA coefficients, shared by all bands
+    float iccAlpha = 0.0f;
+    float azimuthAlpha = 0.0f;
+    float energyAlpha = 0.0f;
+    float iccAlphaControl = 0.0f;
+    float azimuthAlphaControl = 0.0f;
+
+    int numAccumulated = 0;
+};
+
+// All kNumBands band analysers side by side. Holds the same smoothers as
+// AnalysisBand, one lane per band, and updates every band plus the
+// energy-weighted ICC/azimuth aggregate in one 8-wide SIMD pass per sample.
+// AnalysisBand stays the scalar reference; the only deviation is a
+// polynomial atan (fast::atanUnit) in place of std::atan2, used whether or
+// not UPMIXRT_FAST_MATH is set (a per-band std::atan2 would make this pass
+// several times slower).
+// Inputs are interleaved band frames: bandL[s * kNumBands + b].
+class AnalysisBank {
+public:
+    // controlInterval: samples between updateControl() calls in control-rate
+    // mode (1 = per-sample only).
+    void prepare(double sampleRate, int controlInterval = 1,
+                 const SimdKernels& kernels = getSimdKernels());
+    void reset();
+
+    // Per-sample mode. icc[s] and azimuth[s] receive the energy-weighted
+    // aggregates over all bands, energies[s * kNumBands + b] the smoothed
+    // band energies.
+    void processBlock(const float* bandL, const float* bandR, int numSamples,
+                      float* icc, float* azimuth, float* energies);
+
+    // Control-rate mode, step 1: run the energy and covariance smoothers for
+    // numSamples and accumulate the raw azimuth for the interval mean.
+    void accumulate(const float* bandL, const float* bandR, int numSamples);
+
+    // Control-rate mode, step 2: called once every controlInterval samples.
+    // Advances the ICC and azimuth smoothers by a whole interval and returns
+    // the aggregates; energies receives the kNumBands smoothed band energies.
+    void updateControl(float& icc, float& azimuth, float* energies);
+
+private:
+    AnalysisBankState state_;
+    const SimdKernels* kernels_ = &getSimdKernels();
+};
+
+}  // namespace audio_plugin
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Constants.h"
+
+namespace audio_plugin {
+
+// Normalised second-order section coefficients (a0 == 1).
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    // Bilinear-transform designs, identical to juce::dsp::IIR::Coefficients
+    // so filter responses are unchanged from the JUCE-based implementation.
+    static BiquadCoefficients makeLowPass(double sampleRate, float frequency,
+                                          float q = kInvSqrt2);
+    static BiquadCoefficients makeHighPass(double sampleRate, float frequency,
+                                           float q = kInvSqrt2);
+
+    // Samples for the impulse response to decay below threshold, from the
+    // pole radius, doubled to cover repeated poles and initial overshoot.
+    int getTailSamples(float threshold) const;
+};
+
+// Transposed direct form II biquad. Coefficients are stored inline next to
+// the state, so processSample() is a handful of multiply-adds with no
+// indirection.
+class Biquad {
+public:
+    // Filter memory, exposed for kernels that run several biquads in SIMD lanes
+    struct State {
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+    };
+
+    void setCoefficients(const BiquadCoefficients& coefficients) { coeffs_ = coefficients; }
+    const BiquadCoefficients& getCoefficients() const { return coeffs_; }
+
+    State getState() const { return {s1_, s2_}; }
+    void setState(const State& state) {
+        s1_ = state.s1;
+        s2_ = state.s2;
+    }
+
+    void reset() {
+        s1_ = 0.0f;
+        s2_ = 0.0f;
+    }
+
+    float processSample(float input) {
+        float output = coeffs_.b0 * input + s1_;
+        s1_ = coeffs_.b1 * input - coeffs_.a1 * output + s2_;
+        s2_ = coeffs_.b2 * input - coeffs_.a2 * output;
+        return output;
+    }
+
+private:
+    BiquadCoefficients coeffs_;
+    float s1_ = 0.0f;
+    float s2_ = 0.0f;
+};
+
+}  // namespace audio_plugin
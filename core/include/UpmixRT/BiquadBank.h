@@ -0,0 +1,402 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include "Biquad.h"
+#include "Simd.h"
+
+namespace audio_plugin {
+
+// Samples per step of a BlockBiquadBank
+inline constexpr int kBlockBiquadStep = 4;
+
+// The vector kernels live with the SIMD types (see Simd.h); the banks below
+// only hold coefficients and state, and their vector members are templates
+// on the kernel type, so each instruction set instantiates its own copy.
+inline namespace UPMIXRT_SIMD_NAMESPACE {
+
+// Lane vector of a BiquadBank: plain float, Float4 or Float8.
+template <int N>
+struct BiquadLanes;
+
+template <>
+struct BiquadLanes<1> {
+    using Vector = float;
+    static float load(const float* p) { return *p; }
+    static void store(float v, float* p) { *p = v; }
+};
+
+template <>
+struct BiquadLanes<4> {
+    using Vector = Float4;
+    static Float4 load(const float* p) { return Float4::load(p); }
+    static void store(Float4 v, float* p) { v.store(p); }
+};
+
+template <>
+struct BiquadLanes<8> {
+    using Vector = Float8;
+    static Float8 load(const float* p) { return Float8::load(p); }
+    static void store(Float8 v, float* p) { v.store(p); }
+};
+
+// Coefficients and state of a BiquadBank<N> in registers, stepped once per
+// sample by a block loop (BiquadBank::load() / store()).
+template <int N>
+struct BiquadKernel {
+    using Lanes = BiquadLanes<N>;
+    using Vector = typename Lanes::Vector;
+
+    Vector b0, b1, b2, a1, a2;
+    Vector s1, s2;
+
+    // Same operation order as Biquad::processSample
+    Vector process(Vector x) {
+        Vector y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        return y;
+    }
+};
+
+// Lane vector of a BlockBiquadBank: 4 time steps of each of N filters,
+// filter f in lanes [4f, 4f + 4).
+template <int N>
+struct BlockBiquadLanes;
+
+template <>
+struct BlockBiquadLanes<1> {
+    using Vector = Float4;
+    template <int Lane>
+    static Float4 broadcastLane(Float4 v) { return v.broadcastLane<Lane>(); }
+    static void store(Float4 v, float* const* outputs, int s) { v.store(outputs[0] + s); }
+};
+
+template <>
+struct BlockBiquadLanes<2> {
+    using Vector = Float8;
+    template <int Lane>
+    static Float8 broadcastLane(Float8 v) { return v.broadcastLaneInHalves<Lane>(); }
+    static void store(Float8 v, float* const* outputs, int s) {
+        v.lowHalf().store(outputs[0] + s);
+        v.highHalf().store(outputs[1] + s);
+    }
+};
+
+// Step matrices and history of a BlockBiquadBank<N> in registers
+// (BlockBiquadBank::load() / store()).
+template <int N>
+struct BlockBiquadKernel {
+    using Lanes = BlockBiquadLanes<N>;
+    using Vector = typename Lanes::Vector;
+    static constexpr int kStep = kBlockBiquadStep;
+
+    // Response of each filter's kStep outputs to input j of the step,
+    // and to each history term
+    Vector inputToOutput[kStep];
+    Vector lastOutputToOutput, outputDeltaToOutput;
+    Vector lastInputToOutput, inputDeltaToOutput;
+
+    // History: per filter, copied across its lanes (the input terms are
+    // shared by all filters)
+    Vector lastOutput, outputDelta, lastInput, inputDelta;
+
+    // kStep samples of input through every filter; filter f's outputs
+    // are in lanes [4f, 4f + 4)
+    Vector step(const float* input) {
+        Vector x0 = Vector::broadcast(input[0]);
+        Vector x1 = Vector::broadcast(input[1]);
+        Vector x2 = Vector::broadcast(input[2]);
+        Vector x3 = Vector::broadcast(input[3]);
+
+        // Only the output history is on the serial path
+        Vector y = (inputToOutput[0] * x0 + inputToOutput[1] * x1)
+                 + (inputToOutput[2] * x2 + inputToOutput[3] * x3)
+                 + (lastInputToOutput * lastInput + inputDeltaToOutput * inputDelta);
+        y = y + lastOutputToOutput * lastOutput + outputDeltaToOutput * outputDelta;
+
+        Vector last = Lanes::template broadcastLane<kStep - 1>(y);
+        outputDelta = last - Lanes::template broadcastLane<kStep - 2>(y);
+        lastOutput = last;
+        inputDelta = x3 - x2;
+        lastInput = x3;
+        return y;
+    }
+};
+
+}  // namespace UPMIXRT_SIMD_NAMESPACE
+
+// N independent transposed direct form II biquads, stepped together in one
+// SIMD vector (N = 1, 4 or 8). Coefficients and state are kept per lane in
+// SoA arrays. Every parallel filter set in the engine runs on this kernel:
+// the analysis crossovers and bands, and the LFE lowpass.
+// A block loop loads a BiquadKernel (coefficients and state in registers),
+// steps it once per sample and stores the state back. processSample() steps
+// a single lane in scalar code, as the reference for the vector path.
+template <int N>
+class BiquadBank {
+public:
+    static constexpr int kNumLanes = N;
+
+    void setCoefficients(int lane, const BiquadCoefficients& c) {
+        b0_[lane] = c.b0;
+        b1_[lane] = c.b1;
+        b2_[lane] = c.b2;
+        a1_[lane] = c.a1;
+        a2_[lane] = c.a2;
+    }
+
+    // Same coefficients on every lane
+    void setCoefficients(const BiquadCoefficients& c) {
+        for (int lane = 0; lane < N; ++lane)
+            setCoefficients(lane, c);
+    }
+
+    BiquadCoefficients getCoefficients(int lane) const {
+        return { b0_[lane], b1_[lane], b2_[lane], a1_[lane], a2_[lane] };
+    }
+
+    void reset() {
+        std::fill(s1_, s1_ + N, 0.0f);
+        std::fill(s2_, s2_ + N, 0.0f);
+    }
+
+    Biquad::State getState(int lane) const { return { s1_[lane], s2_[lane] }; }
+    void setState(int lane, const Biquad::State& state) {
+        s1_[lane] = state.s1;
+        s2_[lane] = state.s2;
+    }
+
+    template <typename Kernel = BiquadKernel<N>>
+    Kernel load() const {
+        using L = typename Kernel::Lanes;
+        return { L::load(b0_), L::load(b1_), L::load(b2_), L::load(a1_), L::load(a2_),
+                 L::load(s1_), L::load(s2_) };
+    }
+
+    // Writes back the state of a kernel from load()
+    template <typename Kernel>
+    void store(const Kernel& kernel) {
+        Kernel::Lanes::store(kernel.s1, s1_);
+        Kernel::Lanes::store(kernel.s2, s2_);
+    }
+
+    // One sample through one lane
+    float processSample(int lane, float input) {
+        float output = b0_[lane] * input + s1_[lane];
+        s1_[lane] = b1_[lane] * input - a1_[lane] * output + s2_[lane];
+        s2_[lane] = b2_[lane] * input - a2_[lane] * output;
+        return output;
+    }
+
+    // numSamples frames of N interleaved lanes: lane l of sample s is at
+    // [s * N + l]. output may alias input.
+    template <typename Kernel = BiquadKernel<N>>
+    void processBlock(const float* input, float* output, int numSamples) {
+        using L = typename Kernel::Lanes;
+        auto kernel = load<Kernel>();
+        for (int s = 0; s < numSamples; ++s)
+            L::store(kernel.process(L::load(input + s * N)), output + s * N);
+        store(kernel);
+    }
+
+    // Longest tail of any lane; see BiquadCoefficients::getTailSamples().
+    int getTailSamples(float threshold) const {
+        int tail = 0;
+        for (int lane = 0; lane < N; ++lane)
+            tail = std::max(tail, getCoefficients(lane).getTailSamples(threshold));
+        return tail;
+    }
+
+private:
+    static constexpr size_t kSize = static_cast<size_t>(N);
+
+    alignas(32) float b0_[kSize] = {};
+    alignas(32) float b1_[kSize] = {};
+    alignas(32) float b2_[kSize] = {};
+    alignas(32) float a1_[kSize] = {};
+    alignas(32) float a2_[kSize] = {};
+    alignas(32) float s1_[kSize] = {};
+    alignas(32) float s2_[kSize] = {};
+};
+
+// N biquads fed by one input (N = 1 or 2, e.g. the low-pass and high-pass
+// of a crossover), each evaluated kStep samples at a time: a step's kStep
+// outputs are linear in its kStep inputs and the filter history, so a step
+// is a few multiply-adds with lanes along time, and the serial dependency
+// is one step per kStep samples instead of one per sample. A single
+// recursion thus still fills a SIMD vector.
+// The history is the last output and input with their first differences
+// (direct form I in delta form): with the double poles of the Q = 0.5
+// crossovers close to z = 1, that basis keeps the step matrices well
+// conditioned in float, where the transposed direct form II state is not.
+// The outputs match a recursive Biquad to float rounding.
+template <int N>
+class BlockBiquadBank {
+public:
+    static constexpr int kNumFilters = N;
+    static constexpr int kStep = kBlockBiquadStep;
+
+    void setCoefficients(int filter, const BiquadCoefficients& c) {
+        auto& f = filters_[filter];
+        f.coeffs = c;
+        auto& d = f.delta;
+
+        // The recursion rewritten on the delta history: with y2 = y1 - dy
+        // and x2 = x1 - dx,
+        // y = b0 x + (b1 + b2) x1 - b2 dx - (a1 + a2) y1 + a2 dy
+        const auto b0 = static_cast<double>(c.b0), b1 = static_cast<double>(c.b1);
+        const auto b2 = static_cast<double>(c.b2), a1 = static_cast<double>(c.a1);
+        const auto a2 = static_cast<double>(c.a2);
+        d.input = c.b0;
+        d.lastInput = static_cast<float>(b1 + b2);
+        d.inputDelta = -c.b2;
+        d.lastOutput = static_cast<float>(-(a1 + a2));
+        d.outputDelta = c.a2;
+
+        // kStep samples of the recursion in double from a unit input or a
+        // unit history term give one column of the step
+        auto respond = [&](float* column, int unitInput, double y1, double dy, double x1, double dx) {
+            for (int i = 0; i < kStep; ++i) {
+                double x = i == unitInput ? 1.0 : 0.0;
+                double y = b0 * x + (b1 + b2) * x1 - b2 * dx - (a1 + a2) * y1 + a2 * dy;
+                dy = y - y1;
+                y1 = y;
+                dx = x - x1;
+                x1 = x;
+                column[4 * filter + i] = static_cast<float>(y);
+            }
+        };
+
+        for (int j = 0; j < kStep; ++j)
+            respond(inputToOutput_[j], j, 0.0, 0.0, 0.0, 0.0);
+        respond(lastOutputToOutput_, -1, 1.0, 0.0, 0.0, 0.0);
+        respond(outputDeltaToOutput_, -1, 0.0, 1.0, 0.0, 0.0);
+        respond(lastInputToOutput_, -1, 0.0, 0.0, 1.0, 0.0);
+        respond(inputDeltaToOutput_, -1, 0.0, 0.0, 0.0, 1.0);
+    }
+
+    const BiquadCoefficients& getCoefficients(int filter) const { return filters_[filter].coeffs; }
+
+    void reset() {
+        for (auto& f : filters_) {
+            f.lastOutput = 0.0f;
+            f.outputDelta = 0.0f;
+        }
+        lastInput_ = 0.0f;
+        inputDelta_ = 0.0f;
+    }
+
+    template <typename Kernel = BlockBiquadKernel<N>>
+    Kernel load() const {
+        using Vector = typename Kernel::Vector;
+        Kernel kernel;
+        for (int j = 0; j < kStep; ++j)
+            kernel.inputToOutput[j] = Vector::load(inputToOutput_[j]);
+        kernel.lastOutputToOutput = Vector::load(lastOutputToOutput_);
+        kernel.outputDeltaToOutput = Vector::load(outputDeltaToOutput_);
+        kernel.lastInputToOutput = Vector::load(lastInputToOutput_);
+        kernel.inputDeltaToOutput = Vector::load(inputDeltaToOutput_);
+
+        alignas(32) float lastOutput[kLanes], outputDelta[kLanes];
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            lastOutput[lane] = filters_[lane / 4].lastOutput;
+            outputDelta[lane] = filters_[lane / 4].outputDelta;
+        }
+        kernel.lastOutput = Vector::load(lastOutput);
+        kernel.outputDelta = Vector::load(outputDelta);
+        kernel.lastInput = Vector::broadcast(lastInput_);
+        kernel.inputDelta = Vector::broadcast(inputDelta_);
+        return kernel;
+    }
+
+    // Writes back the history of a kernel from load()
+    template <typename Kernel>
+    void store(const Kernel& kernel) {
+        alignas(32) float lastOutput[kLanes], outputDelta[kLanes], lastInput[kLanes], inputDelta[kLanes];
+        kernel.lastOutput.store(lastOutput);
+        kernel.outputDelta.store(outputDelta);
+        kernel.lastInput.store(lastInput);
+        kernel.inputDelta.store(inputDelta);
+        for (size_t f = 0; f < kSize; ++f) {
+            filters_[f].lastOutput = lastOutput[4 * f];
+            filters_[f].outputDelta = outputDelta[4 * f];
+        }
+        lastInput_ = lastInput[0];
+        inputDelta_ = inputDelta[0];
+    }
+
+    // One sample through every filter, recursively: filter f writes
+    // outputs[f]. A template like the vector members, as the block loops
+    // run it on their remainders.
+    template <typename Kernel = BlockBiquadKernel<N>>
+    void processSample(float input, float* outputs) {
+        for (size_t i = 0; i < kSize; ++i) {
+            auto& f = filters_[i];
+            const auto& d = f.delta;
+            float y = d.input * input + d.lastInput * lastInput_ + d.inputDelta * inputDelta_
+                    + d.lastOutput * f.lastOutput + d.outputDelta * f.outputDelta;
+            f.outputDelta = y - f.lastOutput;
+            f.lastOutput = y;
+            outputs[i] = y;
+        }
+        inputDelta_ = input - lastInput_;
+        lastInput_ = input;
+    }
+
+    // Filter f writes outputs[f]; whole steps in block form, the remainder
+    // recursively. An output may alias input.
+    template <typename Kernel = BlockBiquadKernel<N>>
+    void processBlock(const float* input, float* const* outputs, int numSamples) {
+        auto kernel = load<Kernel>();
+        int s = 0;
+        for (; s + kStep <= numSamples; s += kStep)
+            Kernel::Lanes::store(kernel.step(input + s), outputs, s);
+        store(kernel);
+
+        for (; s < numSamples; ++s) {
+            float y[kSize];
+            processSample<Kernel>(input[s], y);
+            for (size_t f = 0; f < kSize; ++f)
+                outputs[f][s] = y[f];
+        }
+    }
+
+    // Longest tail of any filter; see BiquadCoefficients::getTailSamples().
+    int getTailSamples(float threshold) const {
+        int tail = 0;
+        for (const auto& f : filters_)
+            tail = std::max(tail, f.coeffs.getTailSamples(threshold));
+        return tail;
+    }
+
+private:
+    static constexpr size_t kSize = static_cast<size_t>(N);
+    static constexpr size_t kLanes = 4 * kSize;
+
+    // Per-sample recursion on the delta history: the output is the sum of
+    // each history term times its coefficient
+    struct DeltaCoefficients {
+        float input = 1.0f;
+        float lastInput = 0.0f, inputDelta = 0.0f;
+        float lastOutput = 0.0f, outputDelta = 0.0f;
+    };
+
+    struct Filter {
+        BiquadCoefficients coeffs;
+        DeltaCoefficients delta;
+        float lastOutput = 0.0f;
+        float outputDelta = 0.0f;
+    };
+    Filter filters_[kSize];
+    float lastInput_ = 0.0f;
+    float inputDelta_ = 0.0f;
+
+    alignas(32) float inputToOutput_[kStep][kLanes] = {};
+    alignas(32) float lastOutputToOutput_[kLanes] = {};
+    alignas(32) float outputDeltaToOutput_[kLanes] = {};
+    alignas(32) float lastInputToOutput_[kLanes] = {};
+    alignas(32) float inputDeltaToOutput_[kLanes] = {};
+};
+
+}  // namespace audio_plugin
@@ -55,12 +55,32 @@ constexpr float kICCSmoothingTimeSec = 0.008f;
 constexpr float kAzimuthSmoothingTimeSec = 0.010f;
 constexpr float kEnergySmoothingTimeSec = 0.005f;
 
-// Decorrelator (capped < 5ms @ 48kHz)
-constexpr int kDecorrDelaysX[] = {37, 113};    // 2.4ms max
-constexpr int kDecorrDelaysZ[] = {149, 197};   // 4.1ms max
+// Decorrelator (capped < 5ms @ 48kHz). Stages are taken from the front of
+// each table; the default uses the first two.
+constexpr int kMaxDecorrStages = 8;
+constexpr int kDefaultDecorrStages = 2;
+constexpr int kDecorrDelaysX[kMaxDecorrStages] = {37, 113, 61, 89, 47, 131, 73, 103};      // 2.7ms max
+constexpr int kDecorrDelaysZ[kMaxDecorrStages] = {149, 197, 167, 181, 157, 191, 163, 179}; // 4.1ms max
 constexpr float kDecorrRefSampleRate = 48000.0f;
 constexpr float kAllpassCoeff = 0.7f;
 
+// Velvet-noise decorrelators (per-speaker diffuse), see VelvetBudget
+constexpr int kVelvetTapsPerChannel[] = { 0, 8, 16, 32 };  // Off, Low, Medium, High
+constexpr float kVelvetLengthSec = 0.020f;  // 20ms
+constexpr float kVelvetDecayDb = -20.0f;    // envelope at the last tap
+
+// Multirate analysis (AnalysisConfig::multirate)
+constexpr float kMultirateMaxBaseRate = 50000.0f;  // host rate is halved down to at most this
+constexpr int kMultirateNumLowBands = 3;           // bands below kCrossoverFreqs[2] (630 Hz)
+constexpr int kMultirateLowBandStages = 2;         // further halvings for the low bands (x4)
+
+// STFT analysis (AnalysisConfig::engine = AnalysisEngine::Stft)
+constexpr float kStftWindowSec = 0.020f;           // FFT size: next power of two (1024 at 48 kHz)
+constexpr int kStftHopDivisor = 4;                 // hop = FFT size / 4
+constexpr int kStftMaxBands = 64;
+constexpr int kStftDefaultBands = 24;
+constexpr float kStftMaxBandFrequency = 20000.0f;  // bins above belong to the top band
+
 // Height
 constexpr int kHeightHFBandStart = 5;
 constexpr float kHeightMaxElevation = 0.5f;
@@ -69,10 +89,21 @@ constexpr float kHeightMaxElevation = 0.5f;
 constexpr float kLFECutoffHz = 120.0f;
 constexpr float kLFEGainLinear = 0.316f;  // -10dB
 
+// Block processing
+constexpr int kSubBlockSize = 64;  // internal sub-block of the block stages
+
+// Silence skip: filter and decorrelator tails are considered over once they
+// have decayed below this level, and are then cut to exact zeros
+constexpr float kTailThreshold = 1.0e-5f;  // -100 dBFS
+
 // Transitions
 constexpr float kDryWetSmoothTimeSec = 0.020f;   // 20ms
 constexpr float kGainSmoothTimeSec = 0.020f;     // 20ms
+constexpr int kGainRampLength = 64;              // samples per linear gain-ramp segment
+constexpr float kDryWetSettleThreshold = 1.0e-4f; // smoother counts as settled within this
+constexpr float kGainSettleThresholdDb = 1.0e-3f;
 constexpr float kLayoutCrossfadeTimeSec = 0.020f; // 20ms
+constexpr int kLayoutCrossfadeUpdateInterval = 16; // samples per interpolated decoder matrix
 
 constexpr float kEpsilon = 1e-10f;
 constexpr float kPi = 3.14159265358979323846f;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Constants.h"
+
+namespace audio_plugin {
+
+// Cascade of allpass stages. All delay lines live in one allocation made in
+// prepare(); each is a power-of-two ring indexed by a shared sample counter
+// and a mask, so advancing costs no per-stage wraparound.
+class Decorrelator {
+public:
+    // delays: pointer to array of delay values (in samples @ kDecorrRefSampleRate)
+    // numStages: number of allpass stages (any count)
+    void prepare(double sampleRate, const int* delays, int numStages);
+    void reset();
+
+    float process(float input);
+
+    // Block version of process(). input and output may alias.
+    void processBlock(const float* input, float* output, int numSamples);
+
+    // Samples for the output to decay below threshold (relative to the
+    // input level) once the input goes silent. Valid after prepare().
+    int getTailSamples(float threshold) const;
+
+private:
+    struct Stage {
+        size_t offset = 0;   // start of the ring in storage_
+        unsigned mask = 0;   // ring size - 1
+        unsigned delaySamples = 0;
+    };
+
+    std::vector<float> storage_;
+    std::vector<Stage> stages_;
+    unsigned position_ = 0;  // samples processed, wraps
+};
+
+// Two allpass cascades (lanes A and B, e.g. the X and Z decorrelators) fed
+// by the same input and run together: stage k of both lanes shares one
+// interleaved power-of-two ring, so a block pass handles both lanes with
+// the same indexing and adjacent writes. Each lane matches a Decorrelator
+// prepared with its delays.
+class DecorrelatorPair {
+public:
+    void prepare(double sampleRate, const int* delaysA, const int* delaysB, int numStages);
+    void reset();
+
+    void process(float input, float& outputA, float& outputB);
+
+    // Block version of process(). outputA or outputB may alias input.
+    void processBlock(const float* input, float* outputA, float* outputB, int numSamples);
+
+    // Longer of the two lanes' tails; see Decorrelator::getTailSamples().
+    int getTailSamples(float threshold) const;
+
+private:
+    struct Stage {
+        size_t offset = 0;   // start of the interleaved ring in storage_
+        unsigned mask = 0;   // ring size (in frames of two) - 1
+        unsigned delayA = 0;
+        unsigned delayB = 0;
+    };
+
+    std::vector<float> storage_;
+    std::vector<Stage> stages_;
+    unsigned position_ = 0;
+};
+
+}  // namespace audio_plugin
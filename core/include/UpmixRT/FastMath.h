@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Constants.h"
+#include "Simd.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Bounded-error replacements for the libm calls on the per-sample path.
+// Branch-free (selects only, no libm or errno paths), so loops calling them
+// can be auto-vectorised. The hot:: functions below pick between these and
+// std:: at compile time (CMake option UPMIXRT_FAST_MATH); they serve the
+// encoder, the output writer, the diffuseness, the STFT engine and the
+// scalar AnalysisBand reference. The SIMD band analysis (AnalysisBank)
+// always uses fast::atanUnit, whatever the option.
+
+#ifndef UPMIXRT_FAST_MATH
+#define UPMIXRT_FAST_MATH 0
+#endif
+
+namespace audio_plugin {
+
+// Documented maximum absolute errors vs the std:: functions, checked by the
+// FastMath tests
+constexpr float kFastAtanMaxError = 4.0e-7f;         // radians, atanUnit and atan2
+constexpr float kFastCosMaxError = 1.0e-6f;          // |x| <= pi
+constexpr float kFastDbToGainMaxRelError = 1.5e-6f;  // relative, -120..+24 dB
+
+namespace fast {
+
+// atan(x) for |x| <= 1: Cephes atanf polynomial with one range reduction
+// at tan(pi/8).
+inline float atanUnit(float x) {
+    float t = std::abs(x);
+    bool reduce = t > 0.41421356f;
+    float z = reduce ? (t - 1.0f) / (t + 1.0f) : t;
+    float z2 = z * z;
+    float p = ((8.05374449538e-2f * z2 - 1.38776856032e-1f) * z2 + 1.99777106478e-1f) * z2
+              - 3.33329491539e-1f;
+    float y = (reduce ? 0.25f * kPi : 0.0f) + (p * z2 * z + z);
+    return x < 0.0f ? -y : y;
+}
+
+// Same as atanUnit(float), one lane per value
+inline Float8 atanUnit(Float8 x) {
+    const Float8 zero = Float8::broadcast(0.0f);
+    const Float8 one = Float8::broadcast(1.0f);
+    Float8 t = abs(x);
+
+    Float8 reduce = Float8::broadcast(0.41421356f);
+    Float8 z = selectGreater(t, reduce, (t - one) / (t + one), t);
+    Float8 offset = selectGreater(t, reduce, Float8::broadcast(0.25f * kPi), zero);
+
+    Float8 z2 = z * z;
+    Float8 p = ((Float8::broadcast(8.05374449538e-2f) * z2 - Float8::broadcast(1.38776856032e-1f)) * z2
+                + Float8::broadcast(1.99777106478e-1f)) * z2 - Float8::broadcast(3.33329491539e-1f);
+    Float8 y = offset + (p * z2 * z + z);
+
+    return selectGreater(zero, x, zero - y, y);
+}
+
+// Four-quadrant atan2 built on atanUnit. Returns 0 for (0, 0) and +pi on the
+// negative x axis regardless of the sign of a zero y.
+inline float atan2(float y, float x) {
+    float ax = std::abs(x);
+    float ay = std::abs(y);
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    float r = atanUnit(hi > 0.0f ? lo / hi : 0.0f);
+    r = ay > ax ? 0.5f * kPi - r : r;
+    r = x < 0.0f ? kPi - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+// cos(x) for |x| <= pi: even Taylor polynomial to x^10 on [0, pi/2],
+// mirrored for the upper half.
+inline float cos(float x) {
+    float ax = std::abs(x);
+    bool mirror = ax > 0.5f * kPi;
+    float r = mirror ? kPi - ax : ax;
+    float r2 = r * r;
+    float p = 1.0f + r2 * (-1.0f / 2.0f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f
+              + r2 * (1.0f / 40320.0f + r2 * (-1.0f / 3628800.0f)))));
+    return mirror ? -p : p;
+}
+
+// Correctly rounded square root without the libm errno path; negative
+// inputs return 0.
+inline float sqrt(float x) {
+    Float4 v = max(Float4::broadcast(x), Float4::broadcast(0.0f));
+    return sqrt(v).get<0>();  // Float4 overload, found by ADL
+}
+
+// 10^(db/20) as 2^n * 2^f: Cephes exp2f polynomial for f in [-0.5, 0.5),
+// exponent built in the float bits. Exactly 1 at 0 dB. Inputs are clamped
+// to about +-760 dB.
+inline float dbToGain(float db) {
+    constexpr float kLog2Of10Over20 = 0.166096404744368f;  // log2(10) / 20
+    float t = std::clamp(db * kLog2Of10Over20, -126.0f, 127.0f);
+
+    // n = round(t), f = t - n
+    float shifted = t + 0.5f;
+    int n = static_cast<int>(shifted);
+    n -= shifted < static_cast<float>(n) ? 1 : 0;
+    float f = t - static_cast<float>(n);
+
+    float p = ((((1.535336188319500e-4f * f + 1.339887440266574e-3f) * f + 9.618437357674640e-3f) * f
+                + 5.550332471162809e-2f) * f + 2.402264791363012e-1f) * f + 6.931472028550421e-1f;
+    float mantissa = p * f + 1.0f;
+    float scale = std::bit_cast<float>(static_cast<uint32_t>(n + 127) << 23);
+    return mantissa * scale;
+}
+
+}  // namespace fast
+
+// Math used on the per-sample path: the approximations above when built with
+// UPMIXRT_FAST_MATH, the std:: functions otherwise.
+namespace hot {
+
+#if UPMIXRT_FAST_MATH
+inline float atan2(float y, float x) { return fast::atan2(y, x); }
+inline float cos(float x) { return fast::cos(x); }
+inline float sqrt(float x) { return fast::sqrt(x); }
+inline float dbToGain(float db) { return fast::dbToGain(db); }
+#else
+inline float atan2(float y, float x) { return std::atan2(y, x); }
+inline float cos(float x) { return std::cos(x); }
+inline float sqrt(float x) { return std::sqrt(x); }
+inline float dbToGain(float db) { return std::pow(10.0f, db / 20.0f); }
+#endif
+
+}  // namespace hot
+
+}  // namespace audio_plugin
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "BiquadBank.h"
+#include "Constants.h"
+#include "SimdKernels.h"
+
+namespace audio_plugin {
+
+// How the analysis bands are split off.
+// Cascade: each crossover's high-pass feeds the next stage (7 stages deep).
+// Parallel: every band has its own high-pass (lower edge) and low-pass
+// (upper edge) section fed from the input, so the 8 bands are independent
+// and run side by side in 8-wide SIMD, 2 sections deep. Same crossover
+// frequencies and slopes; the bands do not sum back to the input.
+// CascadeTimeParallel: the Cascade filters, but the block path runs each
+// crossover over a sub-block, four samples per step in block form
+// (BlockBiquadBank), lanes along time rather than across filters, so no
+// recursion is stepped one sample at a time. Same bands as Cascade to
+// float rounding.
+enum class FilterBankTopology : int { Cascade = 0, Parallel = 1, CascadeTimeParallel = 2 };
+
+class FilterBank {
+public:
+    // The block paths run on kernels (see SimdKernels.h).
+    void prepare(double sampleRate, FilterBankTopology topology = FilterBankTopology::Cascade,
+                 const SimdKernels& kernels = getSimdKernels());
+    void reset();
+
+    // Parallel topology limited to bands [firstBand, endBand): the lanes of
+    // the other bands output exact zeros. The multirate analysis runs the
+    // low and the upper bands on two such banks at different rates.
+    void prepareBands(double sampleRate, int firstBand, int endBand,
+                      const SimdKernels& kernels = getSimdKernels());
+
+    // Splits a stereo sample into kNumBands frequency bands (analysis only).
+    // bandL[b] and bandR[b] receive the per-band L/R samples.
+    void process(float inputL, float inputR,
+                 float* bandL, float* bandR);
+
+    // Block version of process(), vectorised. Cascade: the four filters of a
+    // stage (lpL, hpL, lpR, hpR) run as one 4-lane SIMD biquad, so a sample
+    // costs 7 vector biquads instead of 28 scalar ones. Parallel: each
+    // section of all 8 bands runs as one 8-lane biquad per channel.
+    // process() is the scalar reference.
+    // bandL[b] and bandR[b] point to numSamples floats for band b.
+    void processBlock(const float* inputL, const float* inputR, int numSamples,
+                      float* const* bandL, float* const* bandR);
+
+    // Same as processBlock(), written frame by frame: framesL[s * kNumBands + b]
+    // holds band b of sample s, ready for 8-wide per-sample band analysis.
+    void processBlockInterleaved(const float* inputL, const float* inputR, int numSamples,
+                                 float* framesL, float* framesR);
+
+    // Samples for every band to decay below threshold once the input goes
+    // silent. Valid after prepare().
+    int getTailSamples(float threshold) const;
+
+    FilterBankTopology getTopology() const { return topology_; }
+
+    // Bank layouts, shared with the block kernels (SimdKernels.cpp).
+    // Cascade topology: one 4-lane bank per crossover, lanes in the order
+    // {lpL, hpL, lpR, hpR}
+    static constexpr int kLaneLowPassL = 0;
+    static constexpr int kLaneHighPassL = 1;
+    static constexpr int kLaneLowPassR = 2;
+    static constexpr int kLaneHighPassR = 3;
+
+    // CascadeTimeParallel topology: the same crossovers, one 2-filter bank
+    // {low-pass, high-pass} per crossover and channel (0 = L, 1 = R)
+    static constexpr int kFilterLowPass = 0;
+    static constexpr int kFilterHighPass = 1;
+
+private:
+    void processBlockKernel(const float* inputL, const float* inputR, int numSamples,
+                            const BandOutputs& outputs);
+
+    BiquadBank<4> stages_[kNumCrossovers];
+    BlockBiquadBank<2> blockStages_[kNumCrossovers][2];
+
+    // Parallel topology: band b = lowPass(highPass(input)), one 8-lane bank
+    // (lane = band) per channel (0 = L, 1 = R) and section (0 = high-pass,
+    // 1 = low-pass). Band 0 has no high-pass and the top band no low-pass
+    // (identity sections).
+    BiquadBank<kNumBands> bandSections_[2][2];
+
+    FilterBankTopology topology_ = FilterBankTopology::Cascade;
+    const SimdKernels* kernels_ = &getSimdKernels();
+    double sampleRate_ = 48000.0;
+};
+
+}  // namespace audio_plugin
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Constants.h"
+
+namespace audio_plugin {
+
+// Half-band lowpass designs (Kaiser windowed sinc, unity gain at DC), given
+// by their odd taps 1, 3, 5, ...; the centre tap is 0.5 and every other
+// even tap is zero.
+// Sharp (31 taps): flat to 0.02 dB up to 0.2 x the input rate, at least
+// 52 dB down from 0.3 x the input rate.
+// Wide (11 taps): flat to 0.02 dB up to 0.125 x the input rate, at least
+// 54 dB down from 0.375 x the input rate. Enough for a stage whose output is
+// decimated again or only used well below its Nyquist frequency.
+enum class HalfBandDesign : int { Sharp = 0, Wide = 1 };
+
+constexpr int kHalfBandSharpPairs = 8;
+constexpr float kHalfBandSharpTaps[kHalfBandSharpPairs] = {
+    3.159216288e-01f, -9.814869556e-02f, 5.100023892e-02f, -2.911689134e-02f,
+    1.649948740e-02f, -8.764708743e-03f, 4.100753018e-03f, -1.491812549e-03f,
+};
+
+constexpr int kHalfBandWidePairs = 3;
+constexpr float kHalfBandWideTaps[kHalfBandWidePairs] = {
+    3.011382953e-01f, -6.354259624e-02f, 1.240430095e-02f,
+};
+
+// Longest design, in taps
+constexpr int kHalfBandMaxLength = 4 * kHalfBandSharpPairs - 1;
+
+// Stereo decimate-by-2 stage of a half-band tree, in polyphase form. Only
+// every second output is computed, and of its taps only the centre (on an
+// even input) and the symmetric pairs (on odd inputs) are non-zero, so the
+// inputs are split into an even and an odd phase and an output costs one
+// multiply per pair plus one per channel, each tap a contiguous run over
+// the block's outputs.
+class HalfBandDecimator {
+public:
+    void prepare(HalfBandDesign design);
+    void reset();
+
+    // Takes numSamples (at most kSubBlockSize) inputs and writes an output
+    // for every second input counted since reset() (the 2nd, 4th, ...), so
+    // blocks of any length chain. Returns the number of outputs written.
+    // The outputs may alias the inputs.
+    int processBlock(const float* inputL, const float* inputR, int numSamples,
+                     float* outputL, float* outputR);
+
+    // Group delay, in input samples
+    int getDelaySamples() const { return 2 * numPairs_ - 1; }
+
+private:
+    static constexpr int kMaxOutputs = kSubBlockSize / 2 + 1;
+    static constexpr int kMaxEvenHistory = kHalfBandSharpPairs - 1;
+    static constexpr int kMaxOddHistory = 2 * kHalfBandSharpPairs - 1;
+
+    const float* taps_ = kHalfBandSharpTaps;
+    int numPairs_ = kHalfBandSharpPairs;
+
+    // Per channel, the history each phase needs (numPairs_ - 1 even and
+    // 2 * numPairs_ - 1 odd inputs), then this block's samples
+    float even_[2][kMaxEvenHistory + kMaxOutputs] = {};
+    float odd_[2][kMaxOddHistory + kMaxOutputs] = {};
+    float pendingInput_[2] = {};
+    bool pending_ = false;  // pendingInput_ is an even input waiting for its pair
+};
+
+}  // namespace audio_plugin
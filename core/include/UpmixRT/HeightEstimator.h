@@ -6,7 +6,8 @@ namespace audio_plugin {
 
 class HeightEstimator {
 public:
-    void prepare(double sampleRate);
+    // updateInterval: samples between process() calls (1 = every sample).
+    void prepare(double sampleRate, int updateInterval = 1);
     void reset();
 
     // Estimate height/elevation from per-band energies.
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace audio_plugin {
+
+// Real-time CPU load of the audio callback.
+// Load = time spent in a block / the block's real-time budget
+// (numSamples / sampleRate); 1.0 means the deadline was just met.
+// Written by the audio thread, read by any other thread. All shared state is
+// in lock-free atomics: recording a block never locks or allocates.
+class LoadMeter {
+public:
+    // Histogram bins: kNumLoadBins - 1 bins of 10% each, the last one
+    // collects blocks at or above 100% load (missed deadlines).
+    static constexpr int kNumLoadBins = 11;
+
+    struct Snapshot {
+        float currentLoad = 0.0f;
+        float peakLoad = 0.0f;
+        uint64_t numBlocks = 0;
+        std::array<uint32_t, kNumLoadBins> histogram{};
+    };
+
+    // Times the enclosing scope and records it as one block.
+    class ScopedMeasurement {
+    public:
+        ScopedMeasurement(LoadMeter& meter, int numSamples)
+            : meter_(meter), numSamples_(numSamples),
+              start_(std::chrono::steady_clock::now()) {}
+
+        ~ScopedMeasurement() {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+            meter_.recordBlock(elapsed.count(), numSamples_);
+        }
+
+        ScopedMeasurement(const ScopedMeasurement&) = delete;
+        ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+    private:
+        LoadMeter& meter_;
+        int numSamples_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Not real-time safe with respect to recordBlock(); call from prepare.
+    void prepare(double sampleRate);
+
+    // Audio thread: records one block that took elapsedSeconds to process.
+    void recordBlock(double elapsedSeconds, int numSamples);
+
+    // Any thread: asks the audio thread to clear the peak and histogram
+    // before its next recordBlock().
+    void requestReset() { resetRequested_.store(true, std::memory_order_relaxed); }
+
+    // Any thread. Fields are read individually, so a snapshot taken while a
+    // block is being recorded may mix that block in partially.
+    Snapshot getSnapshot() const;
+
+private:
+    double sampleRate_ = 48000.0;
+
+    std::atomic<float> currentLoad_{0.0f};
+    std::atomic<float> peakLoad_{0.0f};
+    std::atomic<uint64_t> numBlocks_{0};
+    std::array<std::atomic<uint32_t>, kNumLoadBins> histogram_{};
+    std::atomic<bool> resetRequested_{false};
+};
+
+}  // namespace audio_plugin
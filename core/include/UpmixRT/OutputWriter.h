@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Constants.h"
+#include "SimdKernels.h"
+
+namespace audio_plugin {
+
+// Routes the dry input to main out 1-2 and the wet speaker feeds, scaled by
+// dry/wet and gain, to the aux outputs 3+.
+// Both parameters are smoothed per segment of kGainRampLength samples: at a
+// segment start the dry/wet and gain (dB) smoothers advance a whole segment,
+// and their product is ramped linearly across it as one multiplier. Once both
+// have settled on their targets the segment is a constant multiply, and at
+// zero wet the aux outputs are zero-filled without reading the speaker feeds.
+// Target changes take effect at the next segment start.
+class OutputWriter {
+public:
+    // writeBlock() applies the gain with kernels (see SimdKernels.h).
+    void prepare(double sampleRate, const SimdKernels& kernels = getSimdKernels());
+    void reset();
+
+    // Write one sample to the output buffer.
+    // speakerOutputs: decoded multichannel (up to kMaxOutputChannels).
+    // Contract: decoder fills all kMaxOutputChannels each sample
+    // (active layout channels + zero/fade tail for the rest).
+    // dryL, dryR: original stereo input (always written to main out 1-2)
+    // dryWetTarget: target wet level [0..1] for aux outputs (3+)
+    // gainDbTarget: wet aux output gain (dB)
+    // numOutputChannels: actual output channel count
+    // outputPtrs: array of pointers to output channel buffers
+    // sampleIndex: sample position in current buffer
+    void writeSample(const float* speakerOutputs,
+                     float dryL, float dryR,
+                     float dryWetTarget,
+                     float gainDbTarget,
+                     int numOutputChannels,
+                     float** outputPtrs,
+                     int sampleIndex);
+
+    // Block version of writeSample(), with identical output.
+    // speakerOutputs[ch] points to numSamples floats for each of the first
+    // numOutputChannels - 2 speaker feeds; outputPtrs[ch] to numSamples
+    // floats of output channel ch.
+    void writeBlock(const float* const* speakerOutputs,
+                    const float* dryL, const float* dryR,
+                    int numSamples,
+                    float dryWetTarget,
+                    float gainDbTarget,
+                    int numOutputChannels,
+                    float* const* outputPtrs);
+
+    // Split form of writeBlock() for callers that apply the wet multiplier
+    // themselves, e.g. while decoding straight into the aux outputs.
+    // writeDry() writes main out 1-2; renderWetGain() writes the per-sample
+    // aux multiplier for numSamples to wetGain, advancing the smoothers exactly
+    // as writeBlock() does, and returns false if it is zero throughout.
+    void writeDry(const float* dryL, const float* dryR, int numSamples,
+                  int numOutputChannels, float* const* outputPtrs);
+    bool renderWetGain(int numSamples, float dryWetTarget, float gainDbTarget,
+                       float* wetGain);
+
+private:
+    // Advances the smoothers by one segment and sets up its ramp
+    void beginSegment(float dryWetTarget, float gainDbTarget);
+
+    const SimdKernels* kernels_ = &getSimdKernels();
+
+    float smoothedDryWet_ = 1.0f;
+    float smoothedGainDb_ = 0.0f;
+
+    // Per-segment smoother step: fraction of the distance to the target
+    // covered in kGainRampLength samples
+    float dryWetSegmentAlpha_ = 0.0f;
+    float gainSegmentAlpha_ = 0.0f;
+
+    // Current segment: multiplier = rampStart_ + rampStep_ * (phase + 1)
+    float rampStart_ = 1.0f;
+    float rampStep_ = 0.0f;
+    float rampEnd_ = 1.0f;
+    int rampPhase_ = 0;
+};
+
+}  // namespace audio_plugin
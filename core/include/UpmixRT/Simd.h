@@ -0,0 +1,237 @@
+#pragma once
+
+// Minimal 4- and 8-lane float vectors for the block kernels: SSE2 (AVX for
+// Float8 when the compiler targets it) on x86, NEON on AArch64, plain arrays
+// elsewhere. Only the operations the kernels need.
+// Arithmetic is lane-wise: a kernel that performs the same operations in the
+// same order as its scalar reference matches it up to FMA contraction.
+//
+// The types live in an inline namespace named per translation unit
+// (UPMIXRT_SIMD_NAMESPACE), so the kernels SimdKernels.cpp builds for several
+// instruction sets each get their own copy of every inline function on these
+// types, and the linker never merges an AVX copy into baseline code.
+// UPMIXRT_SIMD_SCALAR forces the plain array implementation.
+
+#ifndef UPMIXRT_SIMD_NAMESPACE
+#define UPMIXRT_SIMD_NAMESPACE simd_baseline
+#endif
+
+#if defined(UPMIXRT_SIMD_SCALAR)
+#include <cmath>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UPMIXRT_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UPMIXRT_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define UPMIXRT_SIMD_SCALAR 1
+#include <cmath>
+#endif
+
+#if defined(__AVX__) && !defined(UPMIXRT_SIMD_SCALAR)
+#define UPMIXRT_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+
+namespace audio_plugin {
+inline namespace UPMIXRT_SIMD_NAMESPACE {
+
+struct Float4 {
+#if UPMIXRT_SIMD_SSE2
+    __m128 v;
+
+    static Float4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Float4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+    static Float4 broadcast(float x) { return {_mm_set1_ps(x)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    template <int Lane>
+    float get() const {
+        return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane)));
+    }
+
+    // {v1, v1, v3, v3}
+    Float4 dupOddLanes() const { return {_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1))}; }
+
+    // Lane copied to all four lanes
+    template <int Lane>
+    Float4 broadcastLane() const { return {_mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane))}; }
+
+    // (v0 + v1) + (v2 + v3)
+    float sum() const {
+        __m128 pairs = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Float4 operator/(Float4 a, Float4 b) { return {_mm_div_ps(a.v, b.v)}; }
+
+    friend Float4 sqrt(Float4 a) { return {_mm_sqrt_ps(a.v)}; }
+    friend Float4 abs(Float4 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    friend Float4 min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    friend Float4 max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+    // Lane-wise (a > b) ? ifTrue : ifFalse
+    friend Float4 selectGreater(Float4 a, Float4 b, Float4 ifTrue, Float4 ifFalse) {
+        __m128 mask = _mm_cmpgt_ps(a.v, b.v);
+        return {_mm_or_ps(_mm_and_ps(mask, ifTrue.v), _mm_andnot_ps(mask, ifFalse.v))};
+    }
+#elif UPMIXRT_SIMD_NEON
+    float32x4_t v;
+
+    static Float4 load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 set(float a, float b, float c, float d) {
+        const float lanes[4] = {a, b, c, d};
+        return {vld1q_f32(lanes)};
+    }
+    static Float4 broadcast(float x) { return {vdupq_n_f32(x)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    template <int Lane>
+    float get() const { return vgetq_lane_f32(v, Lane); }
+
+    Float4 dupOddLanes() const { return {vtrnq_f32(v, v).val[1]}; }
+
+    template <int Lane>
+    Float4 broadcastLane() const { return {vdupq_laneq_f32(v, Lane)}; }
+
+    float sum() const {
+        float32x2_t pairs = vpadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(pairs, 0) + vget_lane_f32(pairs, 1);
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    friend Float4 operator/(Float4 a, Float4 b) { return {vdivq_f32(a.v, b.v)}; }
+
+    friend Float4 sqrt(Float4 a) { return {vsqrtq_f32(a.v)}; }
+    friend Float4 abs(Float4 a) { return {vabsq_f32(a.v)}; }
+    friend Float4 min(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+    friend Float4 max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+
+    friend Float4 selectGreater(Float4 a, Float4 b, Float4 ifTrue, Float4 ifFalse) {
+        return {vbslq_f32(vcgtq_f32(a.v, b.v), ifTrue.v, ifFalse.v)};
+    }
+#else
+    float v[4];
+
+    static Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+    static Float4 broadcast(float x) { return {{x, x, x, x}}; }
+    void store(float* p) const {
+        for (int i = 0; i < 4; ++i)
+            p[i] = v[i];
+    }
+
+    template <int Lane>
+    float get() const { return v[Lane]; }
+
+    Float4 dupOddLanes() const { return {{v[1], v[1], v[3], v[3]}}; }
+
+    template <int Lane>
+    Float4 broadcastLane() const { return {{v[Lane], v[Lane], v[Lane], v[Lane]}}; }
+
+    float sum() const { return (v[0] + v[1]) + (v[2] + v[3]); }
+
+    template <typename Op>
+    static Float4 map(Float4 a, Float4 b, Op op) {
+        return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend Float4 operator-(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend Float4 operator*(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x * y; }); }
+    friend Float4 operator/(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x / y; }); }
+
+    friend Float4 sqrt(Float4 a) { return map(a, a, [](float x, float) { return std::sqrt(x); }); }
+    friend Float4 abs(Float4 a) { return map(a, a, [](float x, float) { return std::abs(x); }); }
+    friend Float4 min(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return y < x ? y : x; }); }
+    friend Float4 max(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x < y ? y : x; }); }
+
+    friend Float4 selectGreater(Float4 a, Float4 b, Float4 ifTrue, Float4 ifFalse) {
+        Float4 result;
+        for (int i = 0; i < 4; ++i)
+            result.v[i] = a.v[i] > b.v[i] ? ifTrue.v[i] : ifFalse.v[i];
+        return result;
+    }
+#endif
+};
+
+// 8 lanes: one AVX register, or a pair of Float4.
+struct Float8 {
+#if UPMIXRT_SIMD_AVX
+    __m256 v;
+
+    static Float8 load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Float8 broadcast(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    Float4 lowHalf() const { return {_mm256_castps256_ps128(v)}; }
+    Float4 highHalf() const { return {_mm256_extractf128_ps(v, 1)}; }
+
+    // Lane of each 4-lane half copied across that half
+    template <int Lane>
+    Float8 broadcastLaneInHalves() const { return {_mm256_permute_ps(v, _MM_SHUFFLE(Lane, Lane, Lane, Lane))}; }
+
+    // Same association as the Float4 pair: lo.sum() + hi.sum()
+    float sum() const {
+        return Float4{_mm256_castps256_ps128(v)}.sum() + Float4{_mm256_extractf128_ps(v, 1)}.sum();
+    }
+
+    friend Float8 operator+(Float8 a, Float8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend Float8 operator-(Float8 a, Float8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend Float8 operator*(Float8 a, Float8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend Float8 operator/(Float8 a, Float8 b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+    friend Float8 sqrt(Float8 a) { return {_mm256_sqrt_ps(a.v)}; }
+    friend Float8 abs(Float8 a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+    friend Float8 min(Float8 a, Float8 b) { return {_mm256_min_ps(a.v, b.v)}; }
+    friend Float8 max(Float8 a, Float8 b) { return {_mm256_max_ps(a.v, b.v)}; }
+
+    friend Float8 selectGreater(Float8 a, Float8 b, Float8 ifTrue, Float8 ifFalse) {
+        return {_mm256_blendv_ps(ifFalse.v, ifTrue.v, _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ))};
+    }
+#else
+    Float4 lo, hi;
+
+    static Float8 load(const float* p) { return {Float4::load(p), Float4::load(p + 4)}; }
+    static Float8 broadcast(float x) {
+        Float4 b = Float4::broadcast(x);
+        return {b, b};
+    }
+    void store(float* p) const {
+        lo.store(p);
+        hi.store(p + 4);
+    }
+
+    Float4 lowHalf() const { return lo; }
+    Float4 highHalf() const { return hi; }
+
+    template <int Lane>
+    Float8 broadcastLaneInHalves() const { return {lo.broadcastLane<Lane>(), hi.broadcastLane<Lane>()}; }
+
+    float sum() const { return lo.sum() + hi.sum(); }
+
+    friend Float8 operator+(Float8 a, Float8 b) { return {a.lo + b.lo, a.hi + b.hi}; }
+    friend Float8 operator-(Float8 a, Float8 b) { return {a.lo - b.lo, a.hi - b.hi}; }
+    friend Float8 operator*(Float8 a, Float8 b) { return {a.lo * b.lo, a.hi * b.hi}; }
+    friend Float8 operator/(Float8 a, Float8 b) { return {a.lo / b.lo, a.hi / b.hi}; }
+
+    friend Float8 sqrt(Float8 a) { return {sqrt(a.lo), sqrt(a.hi)}; }
+    friend Float8 abs(Float8 a) { return {abs(a.lo), abs(a.hi)}; }
+    friend Float8 min(Float8 a, Float8 b) { return {min(a.lo, b.lo), min(a.hi, b.hi)}; }
+    friend Float8 max(Float8 a, Float8 b) { return {max(a.lo, b.lo), max(a.hi, b.hi)}; }
+
+    friend Float8 selectGreater(Float8 a, Float8 b, Float8 ifTrue, Float8 ifFalse) {
+        return {selectGreater(a.lo, b.lo, ifTrue.lo, ifFalse.lo),
+                selectGreater(a.hi, b.hi, ifTrue.hi, ifFalse.hi)};
+    }
+#endif
+};
+
+}  // namespace UPMIXRT_SIMD_NAMESPACE
+}  // namespace audio_plugin
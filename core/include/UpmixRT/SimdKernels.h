@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BiquadBank.h"
+#include "Constants.h"
+
+namespace audio_plugin {
+
+struct AnalysisBankState;
+
+// Instruction sets the hot block kernels are built for, in order of
+// capability. Every build has Scalar (plain C++, no intrinsics); x86 builds
+// add SSE2, AVX2 and AVX-512, AArch64 builds NEON. All levels compute the
+// same output bit for bit; they differ only in speed.
+enum class SimdLevel : int { Scalar = 0, SSE2 = 1, NEON = 2, AVX2 = 3, AVX512 = 4 };
+
+constexpr int kNumSimdLevels = 5;
+
+const char* getSimdLevelName(SimdLevel level);
+
+// Where a filter bank block kernel writes band b of sample s of channel ch
+// (0 = L, 1 = R): bands[ch][b][s] if bands[0] is set, otherwise
+// frames[ch][s * kNumBands + b].
+struct BandOutputs {
+    float* const* bands[2] = {};
+    float* frames[2] = {};
+};
+
+// The hot block loops, built once per instruction set (SimdKernels.cpp is
+// compiled into one translation unit per level with that level's compiler
+// flags). The stages take a table at prepare time and call through it, so
+// one binary runs the widest kernels the CPU supports and never executes an
+// instruction it lacks.
+struct SimdKernels {
+    SimdLevel level;
+
+    // FilterBank::processBlock(), per topology
+    void (*filterBankCascade)(BiquadBank<4>* stages, const float* inputL, const float* inputR,
+                              int numSamples, const BandOutputs& outputs);
+    void (*filterBankParallel)(BiquadBank<kNumBands> (*sections)[2], const float* inputL,
+                               const float* inputR, int numSamples, const BandOutputs& outputs);
+    void (*filterBankTimeParallel)(BlockBiquadBank<2> (*stages)[2], const float* inputL,
+                                   const float* inputR, int numSamples, const BandOutputs& outputs);
+
+    // AnalysisBank::processBlock(), accumulate() and updateControl()
+    void (*analysisProcessBlock)(AnalysisBankState& state, const float* bandL, const float* bandR,
+                                 int numSamples, float* icc, float* azimuth, float* energies);
+    void (*analysisAccumulate)(AnalysisBankState& state, const float* bandL, const float* bandR,
+                               int numSamples);
+    void (*analysisUpdateControl)(AnalysisBankState& state, float& icc, float& azimuth,
+                                  float* energies);
+
+    // AmbisonicDecoder steady state, the layout's specialised kernel: the
+    // first numChannels speakers of a block (the LFE row and null outputs
+    // skipped), times gain[] if given, and every speaker of one frame
+    void (*decodeBlock)(SpeakerLayout layout, const float* const* bFormat, int numSamples,
+                        const float* gain, float* const* speakerOutputs, int numChannels);
+    void (*decodeFrame)(SpeakerLayout layout, const float* frame, float* speakerOutputs);
+
+    // OutputWriter: output[s] = input[s] * gain[s], or times one gain
+    void (*applyGain)(const float* input, const float* gain, float* output, int numSamples);
+    void (*applyConstantGain)(const float* input, float gain, float* output, int numSamples);
+};
+
+// Widest level this CPU supports among those built in; detected once.
+SimdLevel getBestSimdLevel();
+
+// True if level's kernels are built in and this CPU supports them.
+bool isSimdLevelAvailable(SimdLevel level);
+
+// Kernels of the widest available level up to maxLevel (Scalar at worst).
+const SimdKernels& getSimdKernels(SimdLevel maxLevel = SimdLevel::AVX512);
+
+}  // namespace audio_plugin
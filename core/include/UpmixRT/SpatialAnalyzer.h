@@ -0,0 +1,153 @@
+#pragma once
+
+#include "AlignedBuffer.h"
+#include "Constants.h"
+#include "FilterBank.h"
+#include "AnalysisBank.h"
+#include "HalfBandDecimator.h"
+#include "HeightEstimator.h"
+#include "StftAnalyzer.h"
+
+namespace audio_plugin {
+
+// Where the spatial parameters come from.
+// FilterBank: the kNumBands IIR bands (FilterBank, AnalysisBank), per
+// sample or at control rate.
+// Stft: per-bin cross-spectra of a short-time FFT grouped into
+// perceptual bands (StftAnalyzer), derived once per hop and interpolated
+// in between. The results lag the input by getLatencySamples(), which the
+// pipeline compensates by delaying the audio.
+enum class AnalysisEngine : int { FilterBank = 0, Stft = 1 };
+
+// Analyzer options, fixed at prepare time.
+struct AnalysisConfig {
+    // Samples between spatial parameter updates.
+    // 1: per-sample reference (ICC, azimuth and aggregation every sample).
+    // N > 1: control-rate mode. Filters and covariance/energy smoothers still
+    // run every sample, but ICC, azimuth, diffuseness and elevation are
+    // derived once per N samples and linearly interpolated in between, which
+    // delays parameter changes by up to N samples. With N <= 32 at 44.1 kHz
+    // and above, the output stays within the kControlRate*Error bounds of
+    // the per-sample reference once the smoothers have settled (~0.1 s).
+    int controlInterval = 1;
+
+    // Analysis filter bank layout; see FilterBankTopology.
+    FilterBankTopology filterBankTopology = FilterBankTopology::Cascade;
+
+    // Multirate analysis. The input is first halved by half-band stages
+    // (HalfBandDecimator) until its rate is at most kMultirateMaxBaseRate:
+    // not at all at 44.1/48 kHz, once at 88.2/96 kHz, twice at 176.4/192 kHz.
+    // The bands above kCrossoverFreqs[kMultirateNumLowBands - 1] are
+    // analysed at that base rate, the kMultirateNumLowBands low bands after
+    // kMultirateLowBandStages more halvings, so the cost hardly grows with
+    // the host rate. The bands are split in parallel form (see
+    // FilterBankTopology::Parallel; filterBankTopology is ignored), and the
+    // parameters are derived in control-rate mode, with controlInterval
+    // rounded up to a whole low-band sample (4 samples at 48 kHz, 16 at
+    // 192 kHz). Content above 0.4 x the base rate is not analysed. For input
+    // without such content and controlInterval <= 32, the output stays
+    // within the kMultirate*Error bounds of the per-sample reference with
+    // the parallel topology once the smoothers have settled.
+    bool multirate = false;
+
+    // Analysis engine. With Stft, controlInterval, filterBankTopology and
+    // multirate are ignored: parameters are updated once per hop
+    // (StftAnalyzer::getHopSize(), 256 samples at 48 kHz) over stftNumBands
+    // bands (1..kStftMaxBands) evenly spaced on stftBandScale.
+    AnalysisEngine engine = AnalysisEngine::FilterBank;
+    int stftNumBands = kStftDefaultBands;
+    BandScale stftBandScale = BandScale::Bark;
+};
+
+// Control-rate error bounds (max abs deviation from the per-sample path).
+// ICC and diffuseness are dominated by the N-sample update lag; azimuth
+// also tracks the fastest (per-sample) fluctuations of uncorrelated noise.
+constexpr float kControlRateMaxICCError = 0.025f;         // ICC, diffuseness
+constexpr float kControlRateMaxAzimuthError = 0.08f;      // radians
+constexpr float kControlRateMaxElevationError = 0.005f;
+
+// Multirate error bounds (max abs deviation from the full-rate per-sample
+// path). On top of the control-rate lag, the decimators delay the analysis
+// by up to half a millisecond, the low bands more than the upper ones.
+constexpr float kMultirateMaxICCError = 0.04f;           // ICC, diffuseness
+constexpr float kMultirateMaxAzimuthError = 0.15f;       // radians
+constexpr float kMultirateMaxElevationError = 0.01f;
+
+class SpatialAnalyzer {
+public:
+    // The filter bank and band analysis block paths run on kernels.
+    void prepare(double sampleRate, const AnalysisConfig& config = {},
+                 const SimdKernels& kernels = getSimdKernels());
+    void reset();
+
+    // Process one stereo sample pair, return aggregated spatial parameters.
+    SpatialParams process(float inputL, float inputR);
+
+    // Block version of process(): params[s] receives the same values that
+    // process(inputL[s], inputR[s]) would return. Any numSamples is accepted;
+    // work is done in sub-blocks of kSubBlockSize (base-rate) samples.
+    void processBlock(const float* inputL, const float* inputR, int numSamples,
+                      SpatialParams* params);
+
+    // Filter bank tail (host-rate samples); see FilterBank::getTailSamples.
+    // STFT: the window length.
+    int getTailSamples(float threshold) const;
+
+    // Samples the parameters lag the input by and the audio they drive has
+    // to be delayed by: 0 for the filter bank, StftAnalyzer's latency for
+    // the STFT engine.
+    int getLatencySamples() const;
+
+private:
+    void processSubBlock(const float* inputL, const float* inputR, int numSamples,
+                         SpatialParams* params);
+    void processSubBlockControlRate(const float* inputL, const float* inputR, int numSamples,
+                                    SpatialParams* params);
+    void processSubBlockMultirate(const float* inputL, const float* inputR, int numSamples,
+                                  SpatialParams* params);
+    void processSubBlockStft(const float* inputL, const float* inputR, int numSamples,
+                             SpatialParams* params);
+    SpatialParams makeParams(float icc, float azimuth, const float* bandEnergies);
+
+    // Control-rate output: params[s] steps from the current parameters
+    // towards the last target, which the next update replaces
+    void advanceControl(SpatialParams* params, int numSamples);
+    void setControlTarget(const SpatialParams& target);
+
+    FilterBank filterBank_;
+    AnalysisBank bank_;
+    HeightEstimator heightEstimator_;
+
+    // Multirate: host rate to base rate, base rate to low-band rate, and the
+    // low bands' filters and analysers (filterBank_ and bank_ take the
+    // upper bands at the base rate). Host samples per base-rate and per
+    // low-band sample.
+    static constexpr int kMaxRateStages = 4;
+    bool multirate_ = false;
+    int numRateStages_ = 0;
+    HalfBandDecimator rateDecimators_[kMaxRateStages];
+    HalfBandDecimator lowDecimators_[kMultirateLowBandStages];
+    FilterBank lowFilterBank_;
+    AnalysisBank lowBank_;
+    int baseFactor_ = 1;
+    int lowFactor_ = 1;
+
+    // STFT engine; the control-rate state below then steps once per hop
+    AnalysisEngine engine_ = AnalysisEngine::FilterBank;
+    StftAnalyzer stft_;
+
+    // Sub-block scratch, interleaved by sample (kNumBands values each):
+    // band L, band R and band energies, then the aggregated ICC and azimuth;
+    // multirate adds the low bands and the decimated input
+    AlignedBuffer scratch_;
+
+    // Control-rate state: samples since the last update, and the current
+    // interpolated parameters with their per-sample increment (reset()
+    // starts them from the silent-input parameters)
+    int controlInterval_ = 1;
+    int controlPhase_ = 0;
+    SpatialParams current_{};
+    SpatialParams step_{};
+};
+
+}  // namespace audio_plugin
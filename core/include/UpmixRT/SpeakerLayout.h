@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include "Constants.h"
 
 namespace audio_plugin {
@@ -161,4 +163,23 @@ inline constexpr float kDecoderAmbiX[] = {
 inline constexpr float kItuCoeffsAmbiXL[] = { kInvSqrt2, kInvSqrt2, 0.0f, 0.0f };
 inline constexpr float kItuCoeffsAmbiXR[] = { kInvSqrt2, -kInvSqrt2, 0.0f, 0.0f };
 
+// Every layout, indexed by SpeakerLayout. Constexpr so the decoder kernels
+// can be specialised per layout at compile time; getLayoutInfo() is the
+// bounds-checked lookup.
+inline constexpr LayoutInfo kLayoutInfos[] = {
+    { SpeakerLayout::Stereo, 2, "Stereo",
+      kDecoderStereo, kItuCoeffsStereoL, kItuCoeffsStereoR, -1 },
+    { SpeakerLayout::Surround51, 6, "5.1",
+      kDecoder51, kItuCoeffs51L, kItuCoeffs51R, 3 },
+    { SpeakerLayout::Surround714, 12, "7.1.4",
+      kDecoder714, kItuCoeffs714L, kItuCoeffs714R, 3 },
+    { SpeakerLayout::Surround916, 16, "9.1.6",
+      kDecoder916, kItuCoeffs916L, kItuCoeffs916R, 3 },
+    { SpeakerLayout::Surround222, 24, "22.2",
+      kDecoder222, kItuCoeffs222L, kItuCoeffs222R, 3 },
+    { SpeakerLayout::AmbiX, 4, "AmbiX",
+      kDecoderAmbiX, kItuCoeffsAmbiXL, kItuCoeffsAmbiXR, -1 },
+};
+static_assert(std::size(kLayoutInfos) == static_cast<size_t>(SpeakerLayout::kNumLayouts));
+
 }  // namespace audio_plugin
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include "AlignedBuffer.h"
+
+namespace audio_plugin {
+
+// Real FFT of a stereo frame. L and R go in as the real and imaginary parts
+// of one complex radix-2 FFT, whose spectrum is then split into the two
+// real spectra, so a frame costs one complex transform of the same size.
+// The data is kept split (real and imaginary arrays) and every stage's
+// twiddles are stored contiguously, so each butterfly loop is a plain run
+// over arrays.
+class StereoFft {
+public:
+    // size: power of two, at least 4. Allocates; not real-time safe.
+    void prepare(int size);
+
+    int getSize() const { return size_; }
+
+    // Spectra of inputL and inputR (size samples each): bins 0..size/2,
+    // X[k] = sum_n x[n] exp(-2 pi i k n / size), split into real and
+    // imaginary parts.
+    void transform(const float* inputL, const float* inputR,
+                   float* realL, float* imagL, float* realR, float* imagR);
+
+private:
+    int size_ = 0;
+    std::vector<int> bitReverse_;
+    std::vector<float> twiddleCos_;  // stage with half-length h: [h - 1, 2h - 1)
+    std::vector<float> twiddleSin_;
+    AlignedBuffer work_;             // real, imaginary
+};
+
+}  // namespace audio_plugin
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include "AlignedBuffer.h"
+#include "Constants.h"
+#include "StereoFft.h"
+
+namespace audio_plugin {
+
+// Frequency scale the STFT bands are spaced evenly on.
+// Bark: Traunmueller's critical-band rate, z = 26.81 f / (1960 + f) - 0.53.
+// Erb: Glasberg and Moore's ERB number, 21.4 log10(1 + 0.00437 f).
+enum class BandScale : int { Bark = 0, Erb = 1 };
+
+// Spatial analysis from the short-time spectrum: a Hann-windowed FFT of the
+// last fftSize samples every hop, whose per-bin auto- and cross-spectra are
+// summed over perceptual bands. Per band, ICC is the normalised real
+// cross-spectrum (the zero-lag correlation the filter bank measures) and
+// azimuth maps the L and R magnitudes as the per-sample azimuth maps
+// sample amplitudes; covariances, ICC, azimuth and energies are smoothed
+// over hops with the AnalysisBand time constants. The
+// bands are contiguous bin ranges, so a hop costs one FFT plus one pass
+// over the bins whatever the number of bands, plus a few operations per
+// band.
+class StftAnalyzer {
+public:
+    // numBands is clamped to [1, kStftMaxBands]. Allocates; not real-time
+    // safe.
+    void prepare(double sampleRate, int numBands = kStftDefaultBands,
+                 BandScale scale = BandScale::Bark);
+    void reset();
+
+    int getFftSize() const { return fft_.getSize(); }
+    int getHopSize() const { return hopSize_; }
+    int getNumBands() const { return numBands_; }
+
+    // First bin of band b, for b in [0, getNumBands()]; the last entry is
+    // one past the top bin. Bands too narrow for the bin spacing are empty.
+    int getBandStartBin(int band) const { return bandStart_[band]; }
+
+    // Samples between the input and analysis results centred on it, once
+    // they have been interpolated over the following hop: half the window
+    // plus one hop.
+    int getLatencySamples() const { return getFftSize() / 2 + hopSize_; }
+
+    // Appends numSamples input samples, at most the rest of the current hop.
+    void push(const float* inputL, const float* inputR, int numSamples);
+
+    // Called once every hop, after getHopSize() samples have been pushed.
+    // Analyses the last getFftSize() samples and returns the
+    // energy-weighted ICC and azimuth over the bands; energies receives the
+    // kNumBands smoothed energies of the crossover bands (kCrossoverFreqs).
+    void analyse(float& icc, float& azimuth, float* energies);
+
+private:
+    StereoFft fft_;
+    int hopSize_ = 1;
+    int numBands_ = 1;
+    int numFilled_ = 0;
+
+    // Bin ranges of the STFT bands and of the crossover bands
+    int bandStart_[kStftMaxBands + 1] = {};
+    int crossoverStart_[kNumBands + 1] = {};
+
+    std::vector<float> window_;
+    std::vector<float> binScale_;  // per-sample power of a bin, from one side
+
+    // Input frame, then the windowed frame and spectra
+    AlignedBuffer frame_;
+    AlignedBuffer scratch_;
+
+    // Per-band smoothers, advanced once per hop
+    float iccSmooth_[kStftMaxBands] = {};
+    float azimuthSmooth_[kStftMaxBands] = {};
+    float energySmooth_[kStftMaxBands] = {};
+    float crossoverEnergySmooth_[kNumBands] = {};
+    float smoothLL_[kStftMaxBands] = {};
+    float smoothRR_[kStftMaxBands] = {};
+    float smoothLR_[kStftMaxBands] = {};
+    float iccAlpha_ = 0.0f;
+    float azimuthAlpha_ = 0.0f;
+    float energyAlpha_ = 0.0f;
+};
+
+}  // namespace audio_plugin
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Constants.h"
+#include "UpmixPipeline.h"
+
+namespace audio_plugin {
+
+// Upmixes many independent stereo streams in one process.
+// Owns one UpmixPipeline per stream (the same chain the plugin runs) and
+// processes a block of every stream in parallel on a fixed worker pool.
+// Streams are split into one queue per participant; a participant that
+// empties its own queue steals from the others. The calling thread joins
+// in, so process() returns once every stream's block is done.
+class UpmixEngine {
+public:
+    // Per-stream I/O for one process() call; see UpmixPipeline::process.
+    struct StreamBlock {
+        const float* inputL = nullptr;
+        const float* inputR = nullptr;
+        float* const* outputs = nullptr;
+        int numOutputChannels = 0;
+        SpeakerLayout layout = SpeakerLayout::Surround51;
+        float dryWetTarget = 1.0f;
+        float gainDbTarget = 0.0f;
+    };
+
+    UpmixEngine() = default;
+    ~UpmixEngine();
+
+    UpmixEngine(const UpmixEngine&) = delete;
+    UpmixEngine& operator=(const UpmixEngine&) = delete;
+
+    // Allocates the pipelines and starts the workers. Not real-time safe.
+    // numWorkers: extra threads besides the caller (-1 = one per spare
+    // hardware thread, capped at numStreams - 1).
+    // config, velvetBudget, maxSimdLevel: see UpmixPipeline::prepare.
+    void prepare(int numStreams, double sampleRate, int maxBlockSize,
+                 SpeakerLayout layout, int numWorkers = -1,
+                 const AnalysisConfig& config = {},
+                 VelvetBudget velvetBudget = VelvetBudget::Off,
+                 SimdLevel maxSimdLevel = SimdLevel::AVX512);
+
+    // Stops and joins the workers and frees the pipelines.
+    void release();
+
+    // Resets the DSP state of every stream. Must not overlap process().
+    void reset();
+
+    // Processes numSamples of every stream; blocks[i] belongs to stream i.
+    // No allocations or locks. Must be called from one thread at a time.
+    void process(const StreamBlock* blocks, int numSamples);
+
+    int getNumStreams() const { return static_cast<int>(pipelines_.size()); }
+    int getNumWorkers() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct alignas(64) WorkQueue {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    void workerLoop(int queueIndex);
+    void runQueues(int ownQueue);
+
+    std::vector<UpmixPipeline> pipelines_;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<WorkQueue[]> queues_;  // one per worker, plus the caller's
+    int numQueues_ = 0;
+
+    // Current job, published to the workers by bumping generation_
+    const StreamBlock* jobBlocks_ = nullptr;
+    int jobNumSamples_ = 0;
+
+    alignas(64) std::atomic<uint32_t> generation_{0};
+    alignas(64) std::atomic<int> workersDone_{0};
+    std::atomic<bool> stop_{false};
+};
+
+}  // namespace audio_plugin
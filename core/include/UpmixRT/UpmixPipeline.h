@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "AlignedBuffer.h"
+#include "Constants.h"
+#include "SpatialAnalyzer.h"
+#include "AmbisonicEncoder.h"
+#include "AmbisonicDecoder.h"
+#include "OutputWriter.h"
+#include "VelvetDecorrelator.h"
+
+namespace audio_plugin {
+
+// The complete upmix chain for one stereo stream: analysis, B-format
+// encoding, decoding and output writing, run stage by stage over blocks.
+// Shared by the plugin processor and the offline renderer.
+// Digital silence is skipped: once the input has been exactly zero for
+// longer than the filter and decorrelator tails, the chain is reset and
+// bypassed and the outputs are exact zeros until signal returns.
+class UpmixPipeline {
+public:
+    // Allocates all scratch; process() never allocates.
+    // velvetBudget other than Off decorrelates the diffuse signal per
+    // speaker (VelvetDecorrelatorBank) instead of only through X and Z.
+    // The hot block kernels are those of the widest instruction set this
+    // CPU supports, up to maxSimdLevel (see SimdKernels.h).
+    void prepare(double sampleRate, int maxBlockSize, SpeakerLayout layout,
+                 const AnalysisConfig& config = {},
+                 VelvetBudget velvetBudget = VelvetBudget::Off,
+                 SimdLevel maxSimdLevel = SimdLevel::AVX512);
+    void reset();
+
+    // Process one block.
+    // outputs[0..1] receive the dry input (inputL/inputR may alias them),
+    // outputs[2..numOutputChannels) the wet speaker feeds of `layout`.
+    // Blocks longer than maxBlockSize are split internally.
+    void process(const float* inputL, const float* inputR,
+                 float* const* outputs, int numOutputChannels,
+                 int numSamples, SpeakerLayout layout,
+                 float dryWetTarget, float gainDbTarget);
+
+    // Which speaker feed each wet output carries: outputs[2 + k] receives
+    // speaker wetSpeakers[k] of the layout, so only those are decoded.
+    // Wet outputs past numWetChannels, and repeats of a speaker already
+    // routed, stay silent. The default is the identity (outputs[2 + k] =
+    // speaker k). Not real-time safe; call when the output buses change,
+    // never during process().
+    void setOutputRouting(const int* wetSpeakers, int numWetChannels);
+
+    int getMaxBlockSize() const { return maxBlockSize_; }
+
+    // Decorrelator/filter tail after the input goes silent, i.e. how long
+    // the wet outputs keep ringing. 0 before prepare().
+    double getTailLengthSeconds() const;
+
+    // Samples all outputs, dry included, are delayed by so that they line
+    // up with the spatial analysis (SpatialAnalyzer::getLatencySamples());
+    // 0 unless the STFT engine is selected. Report it to the host.
+    int getLatencySamples() const { return latencySamples_; }
+
+    // True while silent input is being skipped.
+    bool isIdle() const { return idle_; }
+
+    // Instruction set of the kernels chosen by prepare().
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+private:
+    SpatialAnalyzer spatialAnalyzer_;
+    AmbisonicEncoder encoder_;
+    AmbisonicDecoder decoder_;
+    OutputWriter outputWriter_;
+    VelvetDecorrelatorBank velvet_;
+    bool useVelvet_ = false;
+    const SimdKernels* kernels_ = &getSimdKernels();
+
+    // Block scratch, sized to maxBlockSize in prepare
+    std::vector<SpatialParams> paramsScratch_;
+    AlignedBuffer bFormatScratch_;
+    AlignedBuffer wetGainScratch_;
+    AlignedBuffer diffuseScratch_;  // diffuse feed for velvet_
+
+    // Latency compensation: the last latencySamples_ input samples, and the
+    // delayed input of the current block
+    AlignedBuffer delayHistory_;
+    AlignedBuffer delayedInput_;
+    int latencySamples_ = 0;
+    int maxBlockSize_ = 0;
+    double sampleRate_ = 48000.0;
+
+    // Speaker feed per wet output channel (-1: silent), see setOutputRouting()
+    std::array<int, kMaxOutputChannels> wetSpeakers_ = makeIdentityRouting();
+
+    static constexpr std::array<int, kMaxOutputChannels> makeIdentityRouting() {
+        std::array<int, kMaxOutputChannels> routing{};
+        for (int k = 0; k < kMaxOutputChannels; ++k)
+            routing[static_cast<size_t>(k)] = k;
+        return routing;
+    }
+
+    // Silence skip: samples of exact-zero input processed so far, capped at
+    // tailSamples_, after which the chain is idle
+    int tailSamples_ = 0;
+    int silentSamples_ = 0;
+    bool idle_ = false;
+};
+
+}  // namespace audio_plugin
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include "AlignedBuffer.h"
+#include "Constants.h"
+
+namespace audio_plugin {
+
+// CPU budget of the per-speaker velvet-noise decorrelators: sparse taps per
+// speaker (kVelvetTapsPerChannel), i.e. multiply-adds per output sample.
+// Off leaves the diffuse signal in the allpass-decorrelated X/Z channels.
+enum class VelvetBudget : int { Off = 0, Low = 1, Medium = 2, High = 3 };
+
+// Bank of velvet-noise decorrelators, one per channel, all fed by the same
+// mono input. Each is a sparse FIR over kVelvetLengthSec: one tap at a
+// random position in each of tapsPerChannel equal grid cells, with a random
+// sign under an exponentially decaying envelope, normalized to unit energy.
+// Tap positions and signs differ per channel, so the outputs are mutually
+// decorrelated. The taps read one shared input history.
+class VelvetDecorrelatorBank {
+public:
+    // Not real-time safe. maxBlockSize bounds numSamples of processBlock().
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, int tapsPerChannel);
+    void reset();
+
+    // Adds channel ch of the decorrelated input to outputs[ch], for the
+    // first numOutputs channels (null outputs are skipped, but the input
+    // history always advances). Channel ch is scaled by a weight ramped
+    // linearly from weightsStart[ch] to weightsEnd[ch] over the block and,
+    // if given, by gain[s].
+    void processBlock(const float* input, int numSamples,
+                      float* const* outputs, int numOutputs,
+                      const float* weightsStart, const float* weightsEnd,
+                      const float* gain = nullptr);
+
+    // Longest tap delay + 1: the output is silent this long after the input.
+    int getTailSamples() const { return historyLength_; }
+
+private:
+    struct Tap {
+        int delay = 0;
+        float weight = 0.0f;  // signed, envelope applied
+    };
+
+    std::vector<Tap> taps_;        // tapsPerChannel_ per channel, channel-major
+    std::vector<float> history_;   // input ring of ringSize_, stored twice
+    AlignedBuffer accumulator_;
+    int historyLength_ = 0;
+    int ringSize_ = 0;             // historyLength_ + maxBlockSize_
+    int writeIndex_ = 0;           // ring position of the next input sample
+    int maxBlockSize_ = 0;
+    int numChannels_ = 0;
+    int tapsPerChannel_ = 0;
+};
+
+}  // namespace audio_plugin
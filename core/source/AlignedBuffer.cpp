@@ -0,0 +1,48 @@
+#include <UpmixRT/AlignedBuffer.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace audio_plugin {
+
+void AlignedBuffer::allocate(int numChannels, int numSamples) {
+    constexpr size_t floatsPerLine = kAlignment / sizeof(float);
+
+    numChannels_ = std::max(0, numChannels);
+    numSamples_ = std::max(0, numSamples);
+
+    // Round each channel up to a whole number of alignment lines
+    stride_ = (static_cast<size_t>(numSamples_) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    // One extra line of slack so the first channel can be shifted onto a boundary
+    storage_.assign(stride_ * static_cast<size_t>(numChannels_) + floatsPerLine, 0.0f);
+
+    auto address = reinterpret_cast<std::uintptr_t>(storage_.data());
+    size_t misalignment = address % kAlignment;
+    size_t offset = (misalignment == 0) ? 0 : (kAlignment - misalignment) / sizeof(float);
+
+    channelPtrs_.resize(static_cast<size_t>(numChannels_));
+    for (size_t ch = 0; ch < channelPtrs_.size(); ++ch)
+        channelPtrs_[ch] = storage_.data() + offset + ch * stride_;
+}
+
+void AlignedBuffer::clear() {
+    std::fill(storage_.begin(), storage_.end(), 0.0f);
+}
+
+float* AlignedBuffer::getChannel(int channel) {
+    return channelPtrs_[static_cast<size_t>(channel)];
+}
+
+const float* AlignedBuffer::getChannel(int channel) const {
+    return channelPtrs_[static_cast<size_t>(channel)];
+}
+
+float* const* AlignedBuffer::getArrayOfChannels() {
+    return channelPtrs_.data();
+}
+
+const float* const* AlignedBuffer::getArrayOfChannels() const {
+    return channelPtrs_.data();
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,232 @@
+#include <UpmixRT/AmbisonicDecoder.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+// ===== Crossfade =====
+
+// One speaker sample from an interpolated W, X, Y, Z, LFE row
+inline float decodeFadeSample(const float* row, float w, float x, float y, float z, float lfe) {
+    return row[BFormat::W] * w + row[BFormat::X] * x + row[BFormat::Y] * y + row[BFormat::Z] * z
+         + row[kNumAmbiChannels] * lfe;
+}
+
+}  // namespace
+
+void AmbisonicDecoder::prepare(double sampleRate, SpeakerLayout layout,
+                               const SimdKernels& kernels) {
+    sampleRate_ = sampleRate;
+    kernels_ = &kernels;
+
+    // LFE filter: 2nd-order Butterworth LP at 120Hz
+    lfeFilter_.setCoefficients(BiquadCoefficients::makeLowPass(sampleRate, kLFECutoffHz));
+
+    crossfadeLength_ = std::max(1, static_cast<int>(sampleRate * static_cast<double>(kLayoutCrossfadeTimeSec)));
+    crossfadePosition_ = crossfadeLength_;
+
+    currentLayout_ = layout;
+    updateLayout(layout);
+}
+
+void AmbisonicDecoder::reset() {
+    lfeFilter_.reset();
+    crossfadePosition_ = crossfadeLength_;
+}
+
+void AmbisonicDecoder::updateLayout(SpeakerLayout layout) {
+    const auto& info = getLayoutInfo(layout);
+    numChannels_ = info.numChannels;
+    lfeChannelIndex_ = info.lfeChannelIndex;
+
+    // Decoder rows with an empty LFE column; the LFE speaker takes only the
+    // lowpassed W feed
+    targetMatrix_.fill(0.0f);
+    for (int spk = 0; spk < info.numChannels; ++spk) {
+        float* row = targetMatrix_.data() + spk * kNumColumns;
+        if (spk == info.lfeChannelIndex) {
+            row[kLfeColumn] = 1.0f;
+        } else {
+            for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+                row[ch] = info.decoderMatrix[spk * kNumAmbiChannels + ch];
+        }
+    }
+}
+
+void AmbisonicDecoder::beginCrossfade(SpeakerLayout layout) {
+    // A change during a crossfade starts from the matrix playing right now
+    if (isCrossfading()) {
+        startMatrix_ = fadeMatrix_;
+    } else {
+        startMatrix_ = targetMatrix_;
+        fadeNumChannels_ = numChannels_;
+    }
+
+    currentLayout_ = layout;
+    updateLayout(layout);
+    fadeNumChannels_ = std::max(fadeNumChannels_, numChannels_);
+    crossfadePosition_ = 0;
+}
+
+void AmbisonicDecoder::updateFadeMatrix() {
+    // Interpolate to where the fade is at the end of this update interval,
+    // so the last interval lands exactly on the target
+    int end = std::min(crossfadePosition_ + kLayoutCrossfadeUpdateInterval, crossfadeLength_);
+    float t = static_cast<float>(end) / static_cast<float>(crossfadeLength_);
+
+    int size = fadeNumChannels_ * kNumColumns;
+    for (int k = 0; k < size; ++k) {
+        auto i = static_cast<size_t>(k);
+        fadeMatrix_[i] = startMatrix_[i] + t * (targetMatrix_[i] - startMatrix_[i]);
+    }
+}
+
+void AmbisonicDecoder::getDiffuseWeights(float* weights, int numSpeakers) const {
+    bool fading = isCrossfading();
+    float t = static_cast<float>(crossfadePosition_) / static_cast<float>(crossfadeLength_);
+    auto entry = [&](int spk, int ch) {
+        auto i = static_cast<size_t>(spk * kNumColumns + ch);
+        return fading ? startMatrix_[i] + t * (targetMatrix_[i] - startMatrix_[i])
+                      : targetMatrix_[i];
+    };
+
+    for (int spk = 0; spk < numSpeakers; ++spk) {
+        float x = entry(spk, BFormat::X);
+        float z = entry(spk, BFormat::Z);
+        weights[spk] = std::sqrt(x * x + z * z);
+    }
+}
+
+void AmbisonicDecoder::decode(const float* bFormat, SpeakerLayout layout,
+                               float* speakerOutputs) {
+    if (layout != currentLayout_)
+        beginCrossfade(layout);
+
+    // The filter runs in every state so it never restarts from stale history
+    float lfeSignal = lfeFilter_.processSample(0, bFormat[BFormat::W]) * kLFEGainLinear;
+
+    if (!isCrossfading()) {
+        // Steady state: the layout's specialised kernel (which skips the LFE row)
+        kernels_->decodeFrame(currentLayout_, bFormat, speakerOutputs);
+
+        for (int spk = numChannels_; spk < kMaxOutputChannels; ++spk)
+            speakerOutputs[spk] = 0.0f;
+
+        if (lfeChannelIndex_ >= 0 && lfeChannelIndex_ < numChannels_)
+            speakerOutputs[lfeChannelIndex_] = lfeSignal;
+        return;
+    }
+
+    // Crossfade: one pass with the interpolated matrix
+    if (crossfadePosition_ % kLayoutCrossfadeUpdateInterval == 0)
+        updateFadeMatrix();
+
+    for (int spk = 0; spk < fadeNumChannels_; ++spk) {
+        speakerOutputs[spk] = decodeFadeSample(fadeMatrix_.data() + spk * kNumColumns,
+                                               bFormat[BFormat::W], bFormat[BFormat::X],
+                                               bFormat[BFormat::Y], bFormat[BFormat::Z], lfeSignal);
+    }
+    for (int spk = fadeNumChannels_; spk < kMaxOutputChannels; ++spk)
+        speakerOutputs[spk] = 0.0f;
+
+    ++crossfadePosition_;
+}
+
+void AmbisonicDecoder::decodeBlock(const float* const* bFormat, int numSamples,
+                                    SpeakerLayout layout,
+                                    float* const* speakerOutputs, int numSpeakerOutputs,
+                                    const float* wetGain) {
+    numSpeakerOutputs = std::min(numSpeakerOutputs, kMaxOutputChannels);
+    const float* w = bFormat[BFormat::W];
+    const float* x = bFormat[BFormat::X];
+    const float* y = bFormat[BFormat::Y];
+    const float* z = bFormat[BFormat::Z];
+    int s = 0;
+
+    // Crossfade: one interpolated matrix per update interval
+    if (layout != currentLayout_)
+        beginCrossfade(layout);
+
+    while (s < numSamples && isCrossfading()) {
+        int phase = crossfadePosition_ % kLayoutCrossfadeUpdateInterval;
+        if (phase == 0)
+            updateFadeMatrix();
+        int n = std::min({ kLayoutCrossfadeUpdateInterval - phase,
+                           crossfadeLength_ - crossfadePosition_, numSamples - s });
+
+        float lfe[kLayoutCrossfadeUpdateInterval];
+        float gain[kLayoutCrossfadeUpdateInterval];
+        lfeFilter_.processBlock(w + s, lfe, n);
+        for (int i = 0; i < n; ++i) {
+            lfe[i] *= kLFEGainLinear;
+            gain[i] = wetGain != nullptr ? wetGain[s + i] : 1.0f;
+        }
+
+        int numCh = std::min(fadeNumChannels_, numSpeakerOutputs);
+        for (int spk = 0; spk < numCh; ++spk) {
+            if (speakerOutputs[spk] == nullptr)
+                continue;
+            const float* row = fadeMatrix_.data() + spk * kNumColumns;
+            float* out = speakerOutputs[spk] + s;
+            for (int i = 0; i < n; ++i)
+                out[i] = decodeFadeSample(row, w[s + i], x[s + i], y[s + i], z[s + i], lfe[i]) * gain[i];
+        }
+        for (int spk = numCh; spk < numSpeakerOutputs; ++spk) {
+            if (speakerOutputs[spk] != nullptr)
+                std::fill(speakerOutputs[spk] + s, speakerOutputs[spk] + s + n, 0.0f);
+        }
+
+        crossfadePosition_ += n;
+        s += n;
+    }
+
+    if (s == numSamples)
+        return;
+
+    // Steady state: the layout's specialised kernel over the rest of the block
+    int n = numSamples - s;
+    const float* in[kNumAmbiChannels] = { w + s, x + s, y + s, z + s };
+
+    int numCh = std::min(numChannels_, numSpeakerOutputs);
+    float* out[kMaxOutputChannels] = {};
+    for (int spk = 0; spk < numCh; ++spk)
+        out[spk] = speakerOutputs[spk] != nullptr ? speakerOutputs[spk] + s : nullptr;
+    kernels_->decodeBlock(currentLayout_, in, n, wetGain != nullptr ? wetGain + s : nullptr, out, numCh);
+
+    for (int spk = numCh; spk < numSpeakerOutputs; ++spk) {
+        if (speakerOutputs[spk] != nullptr)
+            std::fill(speakerOutputs[spk] + s, speakerOutputs[spk] + numSamples, 0.0f);
+    }
+
+    // LFE (skipped by the kernel): the filter runs even when the LFE feed
+    // is not routed, so its state matches the per-sample path
+    if (lfeChannelIndex_ >= 0 && lfeChannelIndex_ < numCh
+        && speakerOutputs[lfeChannelIndex_] != nullptr) {
+        float* lfe = speakerOutputs[lfeChannelIndex_] + s;
+        lfeFilter_.processBlock(w + s, lfe, n);
+        for (int i = 0; i < n; ++i)
+            lfe[i] *= kLFEGainLinear;
+        if (wetGain != nullptr) {
+            for (int i = 0; i < n; ++i)
+                lfe[i] *= wetGain[s + i];
+        }
+    } else {
+        auto kernel = lfeFilter_.load();
+        for (int i = 0; i < n; ++i)
+            kernel.process(w[s + i]);
+        lfeFilter_.store(kernel);
+    }
+}
+
+// ===== Layout info lookup =====
+
+const LayoutInfo& getLayoutInfo(SpeakerLayout layout) {
+    int idx = static_cast<int>(layout);
+    if (idx < 0 || idx >= static_cast<int>(SpeakerLayout::kNumLayouts))
+        idx = 1;  // fallback to 5.1
+    return kLayoutInfos[idx];
+}
+
+}  // namespace audio_plugin
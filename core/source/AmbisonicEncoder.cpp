@@ -0,0 +1,92 @@
+#include <UpmixRT/AmbisonicEncoder.h>
+#include <UpmixRT/FastMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+void AmbisonicEncoder::prepare(double sampleRate, int decorrelatorStages) {
+    decorrXZ_.prepare(sampleRate, kDecorrDelaysX, kDecorrDelaysZ,
+                      std::clamp(decorrelatorStages, 1, kMaxDecorrStages));
+}
+
+void AmbisonicEncoder::reset() {
+    decorrXZ_.reset();
+}
+
+int AmbisonicEncoder::getTailSamples(float threshold) const {
+    return decorrXZ_.getTailSamples(threshold);
+}
+
+void AmbisonicEncoder::encode(float inputL, float inputR,
+                               const SpatialParams& params,
+                               float* bFormat) {
+    float mid = (inputL + inputR) * 0.5f;
+    float side = (inputL - inputR) * 0.5f;
+
+    // Phaseless W and Y (exact reconstruction)
+    bFormat[BFormat::W] = (inputL + inputR) * kInvSqrt2;
+    bFormat[BFormat::Y] = (inputL - inputR) * kInvSqrt2;
+
+    // Front-back enrichment (X)
+    float iccSafe = std::clamp(params.icc, 0.0f, 1.0f);
+    float iccSqrt = hot::sqrt(iccSafe);
+
+    float xDirect = mid * iccSqrt * hot::cos(params.azimuth) * 0.5f;
+    float zDirect = mid * params.elevation * iccSqrt;
+
+    // Diffuse component (decorrelated, added to X and Z only)
+    float diffuseSignal = side * params.diffuseness;
+    float diffuseSpread = 0.5f;
+    float xDiffuse = 0.0f;
+    float zDiffuse = 0.0f;
+    decorrXZ_.process(diffuseSignal, xDiffuse, zDiffuse);
+    xDiffuse *= diffuseSpread;
+    zDiffuse *= diffuseSpread;
+
+    bFormat[BFormat::X] = xDirect + xDiffuse;
+    bFormat[BFormat::Z] = zDirect + zDiffuse;
+}
+
+void AmbisonicEncoder::encodeBlock(const float* inputL, const float* inputR,
+                                    const SpatialParams* params, int numSamples,
+                                    float* const* bFormat, float* diffuseOut) {
+    float* w = bFormat[BFormat::W];
+    float* x = bFormat[BFormat::X];
+    float* y = bFormat[BFormat::Y];
+    float* z = bFormat[BFormat::Z];
+    constexpr float diffuseSpread = 0.5f;
+
+    // Pass 1: phaseless W/Y, and the diffuse feed (staged in Z)
+    for (int s = 0; s < numSamples; ++s) {
+        float l = inputL[s];
+        float r = inputR[s];
+        w[s] = (l + r) * kInvSqrt2;
+        y[s] = (l - r) * kInvSqrt2;
+        z[s] = (l - r) * 0.5f * params[s].diffuseness;
+    }
+
+    // Pass 2: decorrelate the diffuse feed for X and Z, or hand it out
+    const bool decorrelate = diffuseOut == nullptr;
+    if (decorrelate) {
+        decorrXZ_.processBlock(z, x, z, numSamples);
+    } else {
+        for (int s = 0; s < numSamples; ++s)
+            diffuseOut[s] = z[s] * diffuseSpread;
+    }
+
+    // Pass 3: add the direct components
+    for (int s = 0; s < numSamples; ++s) {
+        const auto& p = params[s];
+        float mid = (inputL[s] + inputR[s]) * 0.5f;
+        float iccSqrt = hot::sqrt(std::clamp(p.icc, 0.0f, 1.0f));
+
+        float xDirect = mid * iccSqrt * hot::cos(p.azimuth) * 0.5f;
+        float zDirect = mid * p.elevation * iccSqrt;
+
+        x[s] = decorrelate ? xDirect + x[s] * diffuseSpread : xDirect;
+        z[s] = decorrelate ? zDirect + z[s] * diffuseSpread : zDirect;
+    }
+}
+
+}  // namespace audio_plugin
@@ -1,18 +1,19 @@
 #include <UpmixRT/AnalysisBand.h>
+#include <UpmixRT/FastMath.h>
 #include <algorithm>
 #include <cmath>
 
 namespace audio_plugin {
 
-void AnalysisBand::prepare(double sampleRate) {
-    auto computeAlpha = [&](float timeSec) -> float {
-        if (timeSec <= 0.0f) return 1.0f;
-        return 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * timeSec));
-    };
+float smoothingAlpha(double sampleRate, float timeSec, int steps) {
+    if (timeSec <= 0.0f) return 1.0f;
+    return 1.0f - std::exp(-static_cast<float>(steps) / (static_cast<float>(sampleRate) * timeSec));
+}
 
-    iccAlpha_ = computeAlpha(kICCSmoothingTimeSec);
-    azimuthAlpha_ = computeAlpha(kAzimuthSmoothingTimeSec);
-    energyAlpha_ = computeAlpha(kEnergySmoothingTimeSec);
+void AnalysisBand::prepare(double sampleRate) {
+    iccAlpha_ = smoothingAlpha(sampleRate, kICCSmoothingTimeSec);
+    azimuthAlpha_ = smoothingAlpha(sampleRate, kAzimuthSmoothingTimeSec);
+    energyAlpha_ = smoothingAlpha(sampleRate, kEnergySmoothingTimeSec);
     reset();
 }
 
@@ -38,7 +39,7 @@ BandAnalysis AnalysisBand::process(float bandL, float bandR) {
     smoothRR_ += iccAlpha_ * (bandR * bandR - smoothRR_);
     smoothLR_ += iccAlpha_ * (bandL * bandR - smoothLR_);
 
-    float denom = std::sqrt(smoothLL_ * smoothRR_);
+    float denom = hot::sqrt(smoothLL_ * smoothRR_);
     float icc = (denom > kEpsilon) ? (smoothLR_ / denom) : 0.0f;
     icc = std::clamp(icc, 0.0f, 1.0f);
     iccSmooth_ += iccAlpha_ * (icc - iccSmooth_);
@@ -49,7 +50,7 @@ BandAnalysis AnalysisBand::process(float bandL, float bandR) {
     float azSum = absR + absL;
     float azDiff = absR - absL;
     float azimuth = (azSum > kEpsilon)
-        ? std::atan2(azDiff, azSum) * 2.0f
+        ? hot::atan2(azDiff, azSum) * 2.0f
         : 0.0f;
     azimuthSmooth_ += azimuthAlpha_ * (azimuth - azimuthSmooth_);
 
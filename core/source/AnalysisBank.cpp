@@ -0,0 +1,46 @@
+#include <UpmixRT/AnalysisBank.h>
+#include <UpmixRT/AnalysisBand.h>
+#include <algorithm>
+#include <iterator>
+
+namespace audio_plugin {
+
+void AnalysisBank::prepare(double sampleRate, int controlInterval, const SimdKernels& kernels) {
+    kernels_ = &kernels;
+
+    // Same smoothers as AnalysisBand, plus their control-rate steps
+    state_.iccAlpha = smoothingAlpha(sampleRate, kICCSmoothingTimeSec);
+    state_.azimuthAlpha = smoothingAlpha(sampleRate, kAzimuthSmoothingTimeSec);
+    state_.energyAlpha = smoothingAlpha(sampleRate, kEnergySmoothingTimeSec);
+
+    int interval = std::max(1, controlInterval);
+    state_.iccAlphaControl = smoothingAlpha(sampleRate, kICCSmoothingTimeSec, interval);
+    state_.azimuthAlphaControl = smoothingAlpha(sampleRate, kAzimuthSmoothingTimeSec, interval);
+    reset();
+}
+
+void AnalysisBank::reset() {
+    std::fill(std::begin(state_.iccSmooth), std::end(state_.iccSmooth), 0.0f);
+    std::fill(std::begin(state_.azimuthSmooth), std::end(state_.azimuthSmooth), 0.0f);
+    std::fill(std::begin(state_.energySmooth), std::end(state_.energySmooth), 0.0f);
+    std::fill(std::begin(state_.smoothLL), std::end(state_.smoothLL), 0.0f);
+    std::fill(std::begin(state_.smoothRR), std::end(state_.smoothRR), 0.0f);
+    std::fill(std::begin(state_.smoothLR), std::end(state_.smoothLR), 0.0f);
+    std::fill(std::begin(state_.azimuthSum), std::end(state_.azimuthSum), 0.0f);
+    state_.numAccumulated = 0;
+}
+
+void AnalysisBank::processBlock(const float* bandL, const float* bandR, int numSamples,
+                                float* icc, float* azimuth, float* energies) {
+    kernels_->analysisProcessBlock(state_, bandL, bandR, numSamples, icc, azimuth, energies);
+}
+
+void AnalysisBank::accumulate(const float* bandL, const float* bandR, int numSamples) {
+    kernels_->analysisAccumulate(state_, bandL, bandR, numSamples);
+}
+
+void AnalysisBank::updateControl(float& icc, float& azimuth, float* energies) {
+    kernels_->analysisUpdateControl(state_, icc, azimuth, energies);
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,56 @@
+#include <UpmixRT/Biquad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+BiquadCoefficients BiquadCoefficients::makeLowPass(double sampleRate, float frequency, float q) {
+    float n = 1.0f / std::tan(kPi * frequency / static_cast<float>(sampleRate));
+    float nSquared = n * n;
+    float invQ = 1.0f / q;
+    float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+
+    return BiquadCoefficients{
+        c1,
+        c1 * 2.0f,
+        c1,
+        c1 * 2.0f * (1.0f - nSquared),
+        c1 * (1.0f - invQ * n + nSquared)
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::makeHighPass(double sampleRate, float frequency, float q) {
+    float n = std::tan(kPi * frequency / static_cast<float>(sampleRate));
+    float nSquared = n * n;
+    float invQ = 1.0f / q;
+    float c1 = 1.0f / (1.0f + invQ * n + nSquared);
+
+    return BiquadCoefficients{
+        c1,
+        c1 * -2.0f,
+        c1,
+        c1 * 2.0f * (nSquared - 1.0f),
+        c1 * (1.0f - invQ * n + nSquared)
+    };
+}
+
+int BiquadCoefficients::getTailSamples(float threshold) const {
+    // Poles: roots of z^2 + a1 z + a2
+    const auto c1 = static_cast<double>(a1);
+    const auto c2 = static_cast<double>(a2);
+    double discriminant = c1 * c1 - 4.0 * c2;
+    double radius;
+    if (discriminant < 0.0) {
+        radius = std::sqrt(c2);
+    } else {
+        double root = std::sqrt(discriminant);
+        radius = std::max(std::abs(-c1 + root), std::abs(-c1 - root)) * 0.5;
+    }
+
+    if (radius <= 0.0)
+        return 2;  // FIR: done after the b2 tap
+    radius = std::min(radius, 1.0 - 1.0e-9);
+    return static_cast<int>(std::ceil(2.0 * std::log(static_cast<double>(threshold)) / std::log(radius)));
+}
+
+}  // namespace audio_plugin
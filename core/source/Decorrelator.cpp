@@ -0,0 +1,239 @@
+#include <UpmixRT/Decorrelator.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+// Stage delay at sampleRate for a delay given at kDecorrRefSampleRate
+unsigned scaleDelay(int delay, double sampleRate) {
+    float ratio = static_cast<float>(sampleRate) / kDecorrRefSampleRate;
+    return static_cast<unsigned>(std::max(1, static_cast<int>(std::round(
+        static_cast<float>(delay) * ratio))));
+}
+
+// With no input each stage recirculates its delay line scaled by
+// kAllpassCoeff once per delay. The cascade decays at the rate of its
+// slowest stage, after one pass through every stage.
+int cascadeTailSamples(float threshold, int longestDelay, int totalDelay) {
+    int roundTrips = static_cast<int>(std::ceil(std::log(threshold) / std::log(kAllpassCoeff)));
+    return roundTrips * longestDelay + totalDelay;
+}
+
+// Ring frames for a delay line: a power of two, at least twice the delay
+// so a block run (at most one delay long) never reads where it writes
+unsigned ringSize(unsigned delay) {
+    return std::bit_ceil(2 * delay);
+}
+
+// One allpass stage over n samples in place. The n samples read from
+// delayed were all written before this run (n <= delay).
+void allpassRun(const float* __restrict delayed, float* __restrict write,
+                float* __restrict signal, int n) {
+    for (int i = 0; i < n; ++i) {
+        float stageOut = -kAllpassCoeff * signal[i] + delayed[i];
+        write[i] = signal[i] + kAllpassCoeff * stageOut;
+        signal[i] = stageOut;
+    }
+}
+
+// Both lanes of one interleaved stage over n samples in place. All three
+// ring pointers advance one A, B frame (two floats) per sample.
+void allpassRunPair(const float* __restrict delayedA, const float* __restrict delayedB,
+                    float* __restrict write, float* __restrict signalA,
+                    float* __restrict signalB, int n) {
+    for (int i = 0; i < n; ++i) {
+        float stageOutA = -kAllpassCoeff * signalA[i] + delayedA[2 * i];
+        float stageOutB = -kAllpassCoeff * signalB[i] + delayedB[2 * i];
+        write[2 * i] = signalA[i] + kAllpassCoeff * stageOutA;
+        write[2 * i + 1] = signalB[i] + kAllpassCoeff * stageOutB;
+        signalA[i] = stageOutA;
+        signalB[i] = stageOutB;
+    }
+}
+
+}  // namespace
+
+// ===== Decorrelator =====
+
+void Decorrelator::prepare(double sampleRate, const int* delays, int numStages) {
+    stages_.assign(static_cast<size_t>(std::max(0, numStages)), Stage{});
+
+    size_t size = 0;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        auto& stage = stages_[i];
+        stage.delaySamples = scaleDelay(delays[i], sampleRate);
+        stage.mask = ringSize(stage.delaySamples) - 1;
+        stage.offset = size;
+        size += stage.mask + 1;
+    }
+
+    storage_.assign(size, 0.0f);
+    position_ = 0;
+}
+
+void Decorrelator::reset() {
+    std::fill(storage_.begin(), storage_.end(), 0.0f);
+    position_ = 0;
+}
+
+float Decorrelator::process(float input) {
+    float signal = input;
+
+    for (const auto& stage : stages_) {
+        float* ring = storage_.data() + stage.offset;
+
+        // Allpass, canonical form with the ring holding the feedback:
+        // y = -g*x + d, stored x + g*y, where d was stored delaySamples ago
+        float delayed = ring[(position_ - stage.delaySamples) & stage.mask];
+        float output = -kAllpassCoeff * signal + delayed;
+        ring[position_ & stage.mask] = signal + kAllpassCoeff * output;
+
+        signal = output;
+    }
+
+    ++position_;
+    return signal;
+}
+
+void Decorrelator::processBlock(const float* input, float* output, int numSamples) {
+    if (output != input)
+        std::copy(input, input + numSamples, output);
+
+    // Run each stage over the whole block in place, in runs where neither
+    // the read nor the write index wraps and no sample written in the run
+    // is read back within it, so the inner loop needs no masking and the
+    // compiler is free to vectorize it
+    for (const auto& stage : stages_) {
+        float* ring = storage_.data() + stage.offset;
+        const unsigned size = stage.mask + 1;
+        unsigned pos = position_;
+
+        for (int s = 0; s < numSamples;) {
+            unsigned writeIndex = pos & stage.mask;
+            unsigned readIndex = (pos - stage.delaySamples) & stage.mask;
+            int run = static_cast<int>(std::min({ size - writeIndex, size - readIndex,
+                                                  stage.delaySamples }));
+            run = std::min(run, numSamples - s);
+
+            allpassRun(ring + readIndex, ring + writeIndex, output + s, run);
+            s += run;
+            pos += static_cast<unsigned>(run);
+        }
+    }
+
+    position_ += static_cast<unsigned>(numSamples);
+}
+
+int Decorrelator::getTailSamples(float threshold) const {
+    int longestDelay = 0;
+    int totalDelay = 0;
+    for (const auto& stage : stages_) {
+        int delay = static_cast<int>(stage.delaySamples);
+        longestDelay = std::max(longestDelay, delay);
+        totalDelay += delay;
+    }
+    return cascadeTailSamples(threshold, longestDelay, totalDelay);
+}
+
+// ===== DecorrelatorPair =====
+
+void DecorrelatorPair::prepare(double sampleRate, const int* delaysA, const int* delaysB,
+                               int numStages) {
+    stages_.assign(static_cast<size_t>(std::max(0, numStages)), Stage{});
+
+    size_t size = 0;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        auto& stage = stages_[i];
+        stage.delayA = scaleDelay(delaysA[i], sampleRate);
+        stage.delayB = scaleDelay(delaysB[i], sampleRate);
+        stage.mask = ringSize(std::max(stage.delayA, stage.delayB)) - 1;
+        stage.offset = size;
+        size += 2 * (static_cast<size_t>(stage.mask) + 1);
+    }
+
+    storage_.assign(size, 0.0f);
+    position_ = 0;
+}
+
+void DecorrelatorPair::reset() {
+    std::fill(storage_.begin(), storage_.end(), 0.0f);
+    position_ = 0;
+}
+
+void DecorrelatorPair::process(float input, float& outputA, float& outputB) {
+    float signalA = input;
+    float signalB = input;
+
+    for (const auto& stage : stages_) {
+        float* ring = storage_.data() + stage.offset;
+        float delayedA = ring[2 * ((position_ - stage.delayA) & stage.mask)];
+        float delayedB = ring[2 * ((position_ - stage.delayB) & stage.mask) + 1];
+        float stageOutA = -kAllpassCoeff * signalA + delayedA;
+        float stageOutB = -kAllpassCoeff * signalB + delayedB;
+
+        float* frame = ring + 2 * (position_ & stage.mask);
+        frame[0] = signalA + kAllpassCoeff * stageOutA;
+        frame[1] = signalB + kAllpassCoeff * stageOutB;
+
+        signalA = stageOutA;
+        signalB = stageOutB;
+    }
+
+    ++position_;
+    outputA = signalA;
+    outputB = signalB;
+}
+
+void DecorrelatorPair::processBlock(const float* input, float* outputA, float* outputB,
+                                    int numSamples) {
+    // B first, so an outputA aliasing input is read before it is overwritten
+    if (outputB != input)
+        std::copy(input, input + numSamples, outputB);
+    if (outputA != input)
+        std::copy(input, input + numSamples, outputA);
+
+    // Both lanes of each stage over the whole block, in place, in runs
+    // bounded as in Decorrelator::processBlock()
+    for (const auto& stage : stages_) {
+        float* ring = storage_.data() + stage.offset;
+        const unsigned size = stage.mask + 1;
+        unsigned pos = position_;
+
+        for (int s = 0; s < numSamples;) {
+            unsigned writeIndex = pos & stage.mask;
+            unsigned readIndexA = (pos - stage.delayA) & stage.mask;
+            unsigned readIndexB = (pos - stage.delayB) & stage.mask;
+            int run = static_cast<int>(std::min({ size - writeIndex, size - readIndexA,
+                                                  size - readIndexB, stage.delayA,
+                                                  stage.delayB }));
+            run = std::min(run, numSamples - s);
+
+            allpassRunPair(ring + 2 * readIndexA, ring + 2 * readIndexB + 1,
+                           ring + 2 * writeIndex, outputA + s, outputB + s, run);
+            s += run;
+            pos += static_cast<unsigned>(run);
+        }
+    }
+
+    position_ += static_cast<unsigned>(numSamples);
+}
+
+int DecorrelatorPair::getTailSamples(float threshold) const {
+    int longestA = 0, longestB = 0;
+    int totalA = 0, totalB = 0;
+    for (const auto& stage : stages_) {
+        int delayA = static_cast<int>(stage.delayA);
+        int delayB = static_cast<int>(stage.delayB);
+        longestA = std::max(longestA, delayA);
+        longestB = std::max(longestB, delayB);
+        totalA += delayA;
+        totalB += delayB;
+    }
+    return std::max(cascadeTailSamples(threshold, longestA, totalA),
+                    cascadeTailSamples(threshold, longestB, totalB));
+}
+
+}  // namespace audio_plugin
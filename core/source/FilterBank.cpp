@@ -0,0 +1,164 @@
+#include <UpmixRT/FilterBank.h>
+#include <algorithm>
+
+namespace audio_plugin {
+
+void FilterBank::prepare(double sampleRate, FilterBankTopology topology,
+                         const SimdKernels& kernels) {
+    sampleRate_ = sampleRate;
+    topology_ = topology;
+    kernels_ = &kernels;
+    for (int i = 0; i < kNumCrossovers; ++i) {
+        auto lpCoeffs = BiquadCoefficients::makeLowPass(sampleRate, kCrossoverFreqs[i], 0.5f);
+        auto hpCoeffs = BiquadCoefficients::makeHighPass(sampleRate, kCrossoverFreqs[i], 0.5f);
+
+        stages_[i].setCoefficients(kLaneLowPassL, lpCoeffs);
+        stages_[i].setCoefficients(kLaneHighPassL, hpCoeffs);
+        stages_[i].setCoefficients(kLaneLowPassR, lpCoeffs);
+        stages_[i].setCoefficients(kLaneHighPassR, hpCoeffs);
+
+        for (auto& stage : blockStages_[i]) {
+            stage.setCoefficients(kFilterLowPass, lpCoeffs);
+            stage.setCoefficients(kFilterHighPass, hpCoeffs);
+        }
+    }
+
+    // Parallel bands: high-pass at the lower edge, low-pass at the upper edge
+    for (int b = 0; b < kNumBands; ++b) {
+        BiquadCoefficients sections[2];  // default: identity
+        if (b > 0)
+            sections[0] = BiquadCoefficients::makeHighPass(sampleRate, kCrossoverFreqs[b - 1], 0.5f);
+        if (b < kNumCrossovers)
+            sections[1] = BiquadCoefficients::makeLowPass(sampleRate, kCrossoverFreqs[b], 0.5f);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int sec = 0; sec < 2; ++sec)
+                bandSections_[ch][sec].setCoefficients(b, sections[sec]);
+        }
+    }
+    reset();
+}
+
+void FilterBank::prepareBands(double sampleRate, int firstBand, int endBand,
+                              const SimdKernels& kernels) {
+    prepare(sampleRate, FilterBankTopology::Parallel, kernels);
+
+    // All-zero sections: the lane stays at zero whatever its input
+    const BiquadCoefficients mute{0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (int b = 0; b < kNumBands; ++b) {
+        if (b >= firstBand && b < endBand)
+            continue;
+        for (auto& channel : bandSections_) {
+            for (auto& section : channel)
+                section.setCoefficients(b, mute);
+        }
+    }
+}
+
+void FilterBank::reset() {
+    for (auto& stage : stages_)
+        stage.reset();
+    for (auto& crossover : blockStages_) {
+        for (auto& stage : crossover)
+            stage.reset();
+    }
+    for (auto& channel : bandSections_) {
+        for (auto& section : channel)
+            section.reset();
+    }
+}
+
+void FilterBank::process(float inputL, float inputR,
+                         float* bandL, float* bandR) {
+    if (topology_ == FilterBankTopology::Parallel) {
+        auto& sectionsL = bandSections_[0];
+        auto& sectionsR = bandSections_[1];
+        for (int b = 0; b < kNumBands; ++b) {
+            bandL[b] = sectionsL[1].processSample(b, sectionsL[0].processSample(b, inputL));
+            bandR[b] = sectionsR[1].processSample(b, sectionsR[0].processSample(b, inputR));
+        }
+        return;
+    }
+
+    // Cascade: at each crossover, LP output goes to current band,
+    // HP output continues to the next stage.
+    float remL = inputL;
+    float remR = inputR;
+
+    if (topology_ == FilterBankTopology::CascadeTimeParallel) {
+        for (int i = 0; i < kNumCrossovers; ++i) {
+            float outL[2], outR[2];
+            blockStages_[i][0].processSample(remL, outL);
+            blockStages_[i][1].processSample(remR, outR);
+            bandL[i] = outL[kFilterLowPass];
+            bandR[i] = outR[kFilterLowPass];
+            remL = outL[kFilterHighPass];
+            remR = outR[kFilterHighPass];
+        }
+        bandL[kNumBands - 1] = remL;
+        bandR[kNumBands - 1] = remR;
+        return;
+    }
+
+    for (int i = 0; i < kNumCrossovers; ++i) {
+        bandL[i] = stages_[i].processSample(kLaneLowPassL, remL);
+        bandR[i] = stages_[i].processSample(kLaneLowPassR, remR);
+        remL = stages_[i].processSample(kLaneHighPassL, remL);
+        remR = stages_[i].processSample(kLaneHighPassR, remR);
+    }
+
+    // Last band gets the remainder (everything above the highest crossover)
+    bandL[kNumBands - 1] = remL;
+    bandR[kNumBands - 1] = remR;
+}
+
+void FilterBank::processBlock(const float* inputL, const float* inputR, int numSamples,
+                              float* const* bandL, float* const* bandR) {
+    BandOutputs outputs;
+    outputs.bands[0] = bandL;
+    outputs.bands[1] = bandR;
+    processBlockKernel(inputL, inputR, numSamples, outputs);
+}
+
+void FilterBank::processBlockInterleaved(const float* inputL, const float* inputR, int numSamples,
+                                         float* framesL, float* framesR) {
+    BandOutputs outputs;
+    outputs.frames[0] = framesL;
+    outputs.frames[1] = framesR;
+    processBlockKernel(inputL, inputR, numSamples, outputs);
+}
+
+void FilterBank::processBlockKernel(const float* inputL, const float* inputR, int numSamples,
+                                    const BandOutputs& outputs) {
+    switch (topology_) {
+        case FilterBankTopology::Parallel:
+            kernels_->filterBankParallel(bandSections_, inputL, inputR, numSamples, outputs);
+            break;
+        case FilterBankTopology::CascadeTimeParallel:
+            kernels_->filterBankTimeParallel(blockStages_, inputL, inputR, numSamples, outputs);
+            break;
+        case FilterBankTopology::Cascade:
+            kernels_->filterBankCascade(stages_, inputL, inputR, numSamples, outputs);
+            break;
+    }
+}
+
+int FilterBank::getTailSamples(float threshold) const {
+    if (topology_ == FilterBankTopology::Parallel) {
+        int tail = 0;
+        for (int b = 0; b < kNumBands; ++b) {
+            tail = std::max(tail, bandSections_[0][0].getCoefficients(b).getTailSamples(threshold)
+                                      + bandSections_[0][1].getCoefficients(b).getTailSamples(threshold));
+        }
+        return tail;
+    }
+
+    // Band b runs through the high-passes of stages 0..b-1 and its own
+    // low-pass: bound it by the sum over all stages.
+    int tail = 0;
+    for (const auto& stage : stages_)
+        tail += stage.getTailSamples(threshold);
+    return tail;
+}
+
+}  // namespace audio_plugin
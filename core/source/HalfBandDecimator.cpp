@@ -0,0 +1,81 @@
+#include <UpmixRT/HalfBandDecimator.h>
+#include <algorithm>
+#include <iterator>
+
+namespace audio_plugin {
+
+void HalfBandDecimator::prepare(HalfBandDesign design) {
+    if (design == HalfBandDesign::Wide) {
+        taps_ = kHalfBandWideTaps;
+        numPairs_ = kHalfBandWidePairs;
+    } else {
+        taps_ = kHalfBandSharpTaps;
+        numPairs_ = kHalfBandSharpPairs;
+    }
+    reset();
+}
+
+void HalfBandDecimator::reset() {
+    for (auto& channel : even_)
+        std::fill(std::begin(channel), std::end(channel), 0.0f);
+    for (auto& channel : odd_)
+        std::fill(std::begin(channel), std::end(channel), 0.0f);
+    std::fill(std::begin(pendingInput_), std::end(pendingInput_), 0.0f);
+    pending_ = false;
+}
+
+int HalfBandDecimator::processBlock(const float* inputL, const float* inputR, int numSamples,
+                                    float* outputL, float* outputR) {
+    const float* inputs[2] = {inputL, inputR};
+    float* outputs[2] = {outputL, outputR};
+    const int evenHistory = numPairs_ - 1;
+    const int oddHistory = 2 * numPairs_ - 1;
+    const bool wasPending = pending_;
+    int numOutputs = 0;
+
+    for (int ch = 0; ch < 2; ++ch) {
+        const float* input = inputs[ch];
+        float* even = even_[ch];
+        float* odd = odd_[ch];
+
+        // Split into phases; a trailing even input waits for the next block
+        int s = 0;
+        int j = 0;
+        if (wasPending && numSamples > 0) {
+            even[evenHistory] = pendingInput_[ch];
+            odd[oddHistory] = input[0];
+            s = 1;
+            j = 1;
+        }
+        for (; s + 1 < numSamples; s += 2, ++j) {
+            even[evenHistory + j] = input[s];
+            odd[oddHistory + j] = input[s + 1];
+        }
+        if (s < numSamples)
+            pendingInput_[ch] = input[s];
+        numOutputs = j;
+
+        // Output j: centre on even input j - evenHistory, pair k on odd
+        // inputs j - numPairs_ - k and j - evenHistory + k
+        float sum[kMaxOutputs];
+        for (j = 0; j < numOutputs; ++j)
+            sum[j] = 0.5f * even[j];
+        for (int k = 0; k < numPairs_; ++k) {
+            const float tap = taps_[k];
+            const float* early = odd + evenHistory - k;
+            const float* late = odd + numPairs_ + k;
+            for (j = 0; j < numOutputs; ++j)
+                sum[j] += tap * (early[j] + late[j]);
+        }
+        std::copy(sum, sum + numOutputs, outputs[ch]);
+
+        std::copy(even + numOutputs, even + numOutputs + evenHistory, even);
+        std::copy(odd + numOutputs, odd + numOutputs + oddHistory, odd);
+    }
+
+    if (numSamples > 0)
+        pending_ = ((numSamples + (wasPending ? 1 : 0)) & 1) != 0;
+    return numOutputs;
+}
+
+}  // namespace audio_plugin
@@ -1,12 +1,14 @@
 #include <UpmixRT/HeightEstimator.h>
+#include <algorithm>
 #include <cmath>
 
 namespace audio_plugin {
 
-void HeightEstimator::prepare(double sampleRate) {
+void HeightEstimator::prepare(double sampleRate, int updateInterval) {
     // Use a smoothing time similar to energy smoothing
     float timeSec = 0.010f;
-    alpha_ = 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * timeSec));
+    float steps = static_cast<float>(std::max(1, updateInterval));
+    alpha_ = 1.0f - std::exp(-steps / (static_cast<float>(sampleRate) * timeSec));
     reset();
 }
 
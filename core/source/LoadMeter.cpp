@@ -0,0 +1,50 @@
+#include <UpmixRT/LoadMeter.h>
+#include <algorithm>
+
+namespace audio_plugin {
+
+static_assert(std::atomic<float>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+void LoadMeter::prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    requestReset();
+}
+
+void LoadMeter::recordBlock(double elapsedSeconds, int numSamples) {
+    if (numSamples <= 0)
+        return;
+
+    if (resetRequested_.exchange(false, std::memory_order_relaxed)) {
+        peakLoad_.store(0.0f, std::memory_order_relaxed);
+        numBlocks_.store(0, std::memory_order_relaxed);
+        for (auto& bin : histogram_)
+            bin.store(0, std::memory_order_relaxed);
+    }
+
+    const double budgetSeconds = static_cast<double>(numSamples) / sampleRate_;
+    const auto load = static_cast<float>(elapsedSeconds / budgetSeconds);
+
+    currentLoad_.store(load, std::memory_order_relaxed);
+    if (load > peakLoad_.load(std::memory_order_relaxed))
+        peakLoad_.store(load, std::memory_order_relaxed);
+
+    // Single writer: load/store pairs instead of read-modify-write ops
+    const int bin = std::clamp(static_cast<int>(load * 10.0f), 0, kNumLoadBins - 1);
+    auto& counter = histogram_[static_cast<size_t>(bin)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numBlocks_.store(numBlocks_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+LoadMeter::Snapshot LoadMeter::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.currentLoad = currentLoad_.load(std::memory_order_relaxed);
+    snapshot.peakLoad = peakLoad_.load(std::memory_order_relaxed);
+    snapshot.numBlocks = numBlocks_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < histogram_.size(); ++i)
+        snapshot.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,153 @@
+#include <UpmixRT/OutputWriter.h>
+#include <UpmixRT/FastMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+void OutputWriter::prepare(double sampleRate, const SimdKernels& kernels) {
+    kernels_ = &kernels;
+    auto segmentAlpha = [&](float timeSec) {
+        return 1.0f - std::exp(-static_cast<float>(kGainRampLength) / (static_cast<float>(sampleRate) * timeSec));
+    };
+    dryWetSegmentAlpha_ = segmentAlpha(kDryWetSmoothTimeSec);
+    gainSegmentAlpha_ = segmentAlpha(kGainSmoothTimeSec);
+    reset();
+}
+
+void OutputWriter::reset() {
+    smoothedDryWet_ = 1.0f;
+    smoothedGainDb_ = 0.0f;
+    rampStart_ = 1.0f;
+    rampStep_ = 0.0f;
+    rampEnd_ = 1.0f;
+    rampPhase_ = 0;
+}
+
+void OutputWriter::beginSegment(float dryWetTarget, float gainDbTarget) {
+    // Snap to the target once within the settle threshold, so the ramp
+    // becomes exactly flat; otherwise one smoothing step per segment
+    if (std::abs(dryWetTarget - smoothedDryWet_) <= kDryWetSettleThreshold)
+        smoothedDryWet_ = dryWetTarget;
+    else
+        smoothedDryWet_ += dryWetSegmentAlpha_ * (dryWetTarget - smoothedDryWet_);
+
+    if (std::abs(gainDbTarget - smoothedGainDb_) <= kGainSettleThresholdDb)
+        smoothedGainDb_ = gainDbTarget;
+    else
+        smoothedGainDb_ += gainSegmentAlpha_ * (gainDbTarget - smoothedGainDb_);
+
+    rampStart_ = rampEnd_;
+    rampEnd_ = smoothedDryWet_ * hot::dbToGain(smoothedGainDb_);
+    rampStep_ = (rampEnd_ - rampStart_) / static_cast<float>(kGainRampLength);
+}
+
+void OutputWriter::writeSample(const float* speakerOutputs,
+                                float dryL, float dryR,
+                                float dryWetTarget,
+                                float gainDbTarget,
+                                int numOutputChannels,
+                                float** outputPtrs,
+                                int sampleIndex) {
+    if (rampPhase_ == 0)
+        beginSegment(dryWetTarget, gainDbTarget);
+    ++rampPhase_;
+    float multiplier = rampStart_ + rampStep_ * static_cast<float>(rampPhase_);
+    if (rampPhase_ == kGainRampLength)
+        rampPhase_ = 0;
+
+    // Main stereo out (1-2) is always dry passthrough and never gain-scaled.
+    if (numOutputChannels > 0) {
+        outputPtrs[0][sampleIndex] = dryL;
+    }
+    if (numOutputChannels > 1) {
+        outputPtrs[1][sampleIndex] = dryR;
+    }
+
+    // Upmix appears only on multi-out aux channels (3+), with dry/wet and gain.
+    // `speakerOutputs` is safe to read here because processBlock clamps
+    // `numOutputChannels <= kMaxOutputChannels` and decoder populates all
+    // kMaxOutputChannels each sample (active channels + zero/fade tail).
+    for (int ch = 2; ch < numOutputChannels; ++ch) {
+        int wetChannel = ch - 2;
+        outputPtrs[ch][sampleIndex] = speakerOutputs[wetChannel] * multiplier;
+    }
+}
+
+void OutputWriter::writeBlock(const float* const* speakerOutputs,
+                              const float* dryL, const float* dryR,
+                              int numSamples,
+                              float dryWetTarget,
+                              float gainDbTarget,
+                              int numOutputChannels,
+                              float* const* outputPtrs) {
+    writeDry(dryL, dryR, numSamples, numOutputChannels, outputPtrs);
+
+    int start = 0;
+    while (start < numSamples) {
+        if (rampPhase_ == 0)
+            beginSegment(dryWetTarget, gainDbTarget);
+        int n = std::min(kGainRampLength - rampPhase_, numSamples - start);
+
+        if (std::abs(rampStep_) > 0.0f) {
+            // Ramp: the same per-sample multiplier as writeSample()
+            float multiplier[kGainRampLength];
+            for (int s = 0; s < n; ++s)
+                multiplier[s] = rampStart_ + rampStep_ * static_cast<float>(rampPhase_ + s + 1);
+
+            for (int ch = 2; ch < numOutputChannels; ++ch)
+                kernels_->applyGain(speakerOutputs[ch - 2] + start, multiplier, outputPtrs[ch] + start, n);
+        } else if (std::abs(rampStart_) > 0.0f) {
+            // Settled: one constant multiplier
+            for (int ch = 2; ch < numOutputChannels; ++ch)
+                kernels_->applyConstantGain(speakerOutputs[ch - 2] + start, rampStart_, outputPtrs[ch] + start, n);
+        } else {
+            // Settled at zero wet: the speaker feeds are not read
+            for (int ch = 2; ch < numOutputChannels; ++ch)
+                std::fill(outputPtrs[ch] + start, outputPtrs[ch] + start + n, 0.0f);
+        }
+
+        start += n;
+        rampPhase_ += n;
+        if (rampPhase_ == kGainRampLength)
+            rampPhase_ = 0;
+    }
+}
+
+void OutputWriter::writeDry(const float* dryL, const float* dryR, int numSamples,
+                            int numOutputChannels, float* const* outputPtrs) {
+    // Main stereo out: dry passthrough (a no-op when the host processes in place)
+    if (numOutputChannels > 0 && outputPtrs[0] != dryL)
+        std::copy(dryL, dryL + numSamples, outputPtrs[0]);
+    if (numOutputChannels > 1 && outputPtrs[1] != dryR)
+        std::copy(dryR, dryR + numSamples, outputPtrs[1]);
+}
+
+bool OutputWriter::renderWetGain(int numSamples, float dryWetTarget, float gainDbTarget,
+                                 float* wetGain) {
+    bool nonZero = false;
+    int start = 0;
+    while (start < numSamples) {
+        if (rampPhase_ == 0)
+            beginSegment(dryWetTarget, gainDbTarget);
+        int n = std::min(kGainRampLength - rampPhase_, numSamples - start);
+
+        // Same multiplier as writeSample() and writeBlock()
+        if (std::abs(rampStep_) > 0.0f) {
+            for (int s = 0; s < n; ++s)
+                wetGain[start + s] = rampStart_ + rampStep_ * static_cast<float>(rampPhase_ + s + 1);
+            nonZero = true;
+        } else {
+            std::fill(wetGain + start, wetGain + start + n, rampStart_);
+            nonZero = nonZero || std::abs(rampStart_) > 0.0f;
+        }
+
+        start += n;
+        rampPhase_ += n;
+        if (rampPhase_ == kGainRampLength)
+            rampPhase_ = 0;
+    }
+    return nonZero;
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,154 @@
+#include <UpmixRT/SimdKernels.h>
+#include <algorithm>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define UPMIXRT_CPU_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define UPMIXRT_CPU_ARM64 1
+#endif
+
+namespace audio_plugin {
+
+// The table of each SimdKernels.cpp translation unit core/CMakeLists.txt
+// builds (UPMIXRT_KERNELS_<level>), in the namespace it is compiled into
+namespace simd_scalar {
+const SimdKernels& getKernelTable();
+}
+#if UPMIXRT_KERNELS_SSE2 && UPMIXRT_CPU_X86
+namespace simd_sse2 {
+const SimdKernels& getKernelTable();
+}
+#endif
+#if UPMIXRT_KERNELS_AVX2 && UPMIXRT_CPU_X86
+namespace simd_avx2 {
+const SimdKernels& getKernelTable();
+}
+#endif
+#if UPMIXRT_KERNELS_AVX512 && UPMIXRT_CPU_X86
+namespace simd_avx512 {
+const SimdKernels& getKernelTable();
+}
+#endif
+#if UPMIXRT_KERNELS_NEON && UPMIXRT_CPU_ARM64
+namespace simd_neon {
+const SimdKernels& getKernelTable();
+}
+#endif
+
+namespace {
+
+// What the CPU (and, for the wide registers, the OS) supports
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512 = false;  // AVX-512 F, VL, BW and DQ
+    bool neon = false;
+};
+
+CpuFeatures detectCpuFeatures() {
+    CpuFeatures features;
+#if UPMIXRT_CPU_X86 && (defined(__GNUC__) || defined(__clang__))
+    // Also checks that the OS saves the YMM/ZMM state
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512 = features.avx2 && __builtin_cpu_supports("avx512f")
+                      && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw")
+                      && __builtin_cpu_supports("avx512dq");
+#elif UPMIXRT_CPU_X86 && defined(_MSC_VER)
+    auto bit = [](int reg, int index) { return ((static_cast<unsigned>(reg) >> index) & 1u) != 0; };
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+
+    __cpuid(regs, 1);
+    features.sse2 = bit(regs[3], 26);
+    bool osxsave = bit(regs[2], 27);
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool ymmState = (xcr0 & 0x6) == 0x6;
+    bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        features.avx2 = ymmState && bit(regs[1], 5);
+        features.avx512 = features.avx2 && zmmState && bit(regs[1], 16) && bit(regs[1], 17)
+                          && bit(regs[1], 30) && bit(regs[1], 31);
+    }
+#elif UPMIXRT_CPU_ARM64
+    features.neon = true;  // part of the AArch64 baseline
+#endif
+    return features;
+}
+
+const CpuFeatures& getCpuFeatures() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+// level's table if it is built in and the CPU supports it, else nullptr
+const SimdKernels* findKernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return &simd_scalar::getKernelTable();
+        case SimdLevel::SSE2:
+#if UPMIXRT_KERNELS_SSE2 && UPMIXRT_CPU_X86
+            return getCpuFeatures().sse2 ? &simd_sse2::getKernelTable() : nullptr;
+#else
+            return nullptr;
+#endif
+        case SimdLevel::AVX2:
+#if UPMIXRT_KERNELS_AVX2 && UPMIXRT_CPU_X86
+            return getCpuFeatures().avx2 ? &simd_avx2::getKernelTable() : nullptr;
+#else
+            return nullptr;
+#endif
+        case SimdLevel::AVX512:
+#if UPMIXRT_KERNELS_AVX512 && UPMIXRT_CPU_X86
+            return getCpuFeatures().avx512 ? &simd_avx512::getKernelTable() : nullptr;
+#else
+            return nullptr;
+#endif
+        case SimdLevel::NEON:
+#if UPMIXRT_KERNELS_NEON && UPMIXRT_CPU_ARM64
+            return getCpuFeatures().neon ? &simd_neon::getKernelTable() : nullptr;
+#else
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+const char* getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::NEON: return "NEON";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+    }
+    return "Unknown";
+}
+
+bool isSimdLevelAvailable(SimdLevel level) {
+    return findKernels(level) != nullptr;
+}
+
+SimdLevel getBestSimdLevel() {
+    return getSimdKernels().level;
+}
+
+const SimdKernels& getSimdKernels(SimdLevel maxLevel) {
+    for (int level = std::min(static_cast<int>(maxLevel), kNumSimdLevels - 1); level > 0; --level) {
+        if (const SimdKernels* kernels = findKernels(static_cast<SimdLevel>(level)))
+            return *kernels;
+    }
+    return simd_scalar::getKernelTable();
+}
+
+}  // namespace audio_plugin
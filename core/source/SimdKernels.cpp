@@ -0,0 +1,491 @@
+// The hot block loops behind SimdKernels. core/CMakeLists.txt compiles this
+// file once per SimdLevel, each time with that level's compiler flags,
+// UPMIXRT_SIMD_KERNEL_LEVEL and its own UPMIXRT_SIMD_NAMESPACE (see Simd.h);
+// SimdDispatch.cpp picks a table at runtime.
+//
+// Nothing here may call an inline function shared with the baseline code:
+// the copy compiled here could hold instructions the CPU lacks and still be
+// the one the linker keeps for every caller. So the loops below avoid std::
+// algorithms, and the bank members they call are templates on the kernel
+// type, instantiated per level.
+
+#include <UpmixRT/AnalysisBank.h>
+#include <UpmixRT/FastMath.h>
+#include <UpmixRT/FilterBank.h>
+#include <UpmixRT/SimdKernels.h>
+#include <UpmixRT/SpeakerLayout.h>
+#include <type_traits>
+#include <utility>
+
+#ifndef UPMIXRT_SIMD_KERNEL_LEVEL
+#error "SimdKernels.cpp is built per SimdLevel by core/CMakeLists.txt"
+#endif
+
+// A universal (multi-architecture) build compiles every level for every
+// slice; only the levels the slice's compiler targets produce a table.
+#define UPMIXRT_SIMD_LEVEL_Scalar 1
+#define UPMIXRT_SIMD_LEVEL_SSE2 UPMIXRT_SIMD_SSE2
+#define UPMIXRT_SIMD_LEVEL_NEON UPMIXRT_SIMD_NEON
+#define UPMIXRT_SIMD_LEVEL_AVX2 UPMIXRT_SIMD_AVX
+#define UPMIXRT_SIMD_LEVEL_AVX512 UPMIXRT_SIMD_AVX
+#define UPMIXRT_SIMD_LEVEL_ENABLED(level) UPMIXRT_SIMD_LEVEL_##level
+#define UPMIXRT_SIMD_KERNEL_ENABLED(level) UPMIXRT_SIMD_LEVEL_ENABLED(level)
+
+#if UPMIXRT_SIMD_KERNEL_ENABLED(UPMIXRT_SIMD_KERNEL_LEVEL)
+
+namespace audio_plugin {
+inline namespace UPMIXRT_SIMD_NAMESPACE {
+
+static_assert(kNumBands == 8, "the band kernels run one Float8 lane per band");
+
+namespace {
+
+// ===== FilterBank =====
+
+// Block kernel outputs: channel 0 = L, 1 = R
+struct BandMajorOutput {
+    float* const* bands[2];
+    float& at(int ch, int band, int s) const { return bands[ch][band][s]; }
+};
+
+struct InterleavedOutput {
+    float* frames[2];
+    float& at(int ch, int band, int s) const { return frames[ch][s * kNumBands + band]; }
+};
+
+// Calls fn(output) with the layout outputs asks for
+template <typename Fn>
+void withOutput(const BandOutputs& outputs, Fn&& fn) {
+    if (outputs.bands[0] != nullptr)
+        fn(BandMajorOutput{{outputs.bands[0], outputs.bands[1]}});
+    else
+        fn(InterleavedOutput{{outputs.frames[0], outputs.frames[1]}});
+}
+
+template <typename Output>
+void cascade(BiquadBank<4>* stages, const float* inputL, const float* inputR, int numSamples,
+             const Output& output) {
+    // Lanes {lpL, hpL, lpR, hpR}: every stage takes {remL, remL, remR, remR}
+    // and yields {bandL, remL', bandR, remR'}.
+    BiquadKernel<4> kernels[kNumCrossovers];
+    for (int i = 0; i < kNumCrossovers; ++i)
+        kernels[i] = stages[i].load();
+
+    for (int s = 0; s < numSamples; ++s) {
+        Float4 x = Float4::set(inputL[s], inputL[s], inputR[s], inputR[s]);
+
+        for (int i = 0; i < kNumCrossovers; ++i) {
+            Float4 y = kernels[i].process(x);
+            output.at(0, i, s) = y.get<FilterBank::kLaneLowPassL>();
+            output.at(1, i, s) = y.get<FilterBank::kLaneLowPassR>();
+            x = y.dupOddLanes();
+        }
+
+        // Last band gets the remainder
+        output.at(0, kNumBands - 1, s) = x.get<0>();
+        output.at(1, kNumBands - 1, s) = x.get<2>();
+    }
+
+    for (int i = 0; i < kNumCrossovers; ++i)
+        stages[i].store(kernels[i]);
+}
+
+template <typename Output>
+void cascadeTimeParallel(BlockBiquadBank<2> (*stages)[2], const float* inputL, const float* inputR,
+                         int numSamples, const Output& output) {
+    // Crossover by crossover over sub-blocks: the low-pass writes the band
+    // and the high-pass rewrites the remainder in place. L and R are
+    // stepped together so their serial paths overlap.
+    using Kernel = BlockBiquadKernel<2>;
+    constexpr int kStep = Kernel::kStep;
+    constexpr int kLowPass = FilterBank::kFilterLowPass;
+    constexpr int kHighPass = FilterBank::kFilterHighPass;
+    alignas(16) float bands[2][kNumBands][kSubBlockSize];
+
+    for (int start = 0; start < numSamples; start += kSubBlockSize) {
+        int n = numSamples - start < kSubBlockSize ? numSamples - start : kSubBlockSize;
+        float* remL = bands[0][kNumBands - 1];
+        float* remR = bands[1][kNumBands - 1];
+        for (int s = 0; s < n; ++s) {
+            remL[s] = inputL[start + s];
+            remR[s] = inputR[start + s];
+        }
+
+        // Band-major output takes the low-pass bands directly
+        constexpr bool kDirect = std::is_same_v<Output, BandMajorOutput>;
+        for (int i = 0; i < kNumCrossovers; ++i) {
+            float* bandL = kDirect ? &output.at(0, i, start) : bands[0][i];
+            float* bandR = kDirect ? &output.at(1, i, start) : bands[1][i];
+            float* outputsL[2] = {bandL, remL};
+            float* outputsR[2] = {bandR, remR};
+            Kernel kernelL = stages[i][0].load();
+            Kernel kernelR = stages[i][1].load();
+
+            int s = 0;
+            for (; s + kStep <= n; s += kStep) {
+                Kernel::Lanes::store(kernelL.step(remL + s), outputsL, s);
+                Kernel::Lanes::store(kernelR.step(remR + s), outputsR, s);
+            }
+            stages[i][0].store(kernelL);
+            stages[i][1].store(kernelR);
+
+            // Remainder of a short sub-block, recursively
+            for (; s < n; ++s) {
+                float outL[2], outR[2];
+                stages[i][0].processSample(remL[s], outL);
+                stages[i][1].processSample(remR[s], outR);
+                bandL[s] = outL[kLowPass];
+                bandR[s] = outR[kLowPass];
+                remL[s] = outL[kHighPass];
+                remR[s] = outR[kHighPass];
+            }
+        }
+
+        int firstBand = kDirect ? kNumBands - 1 : 0;
+        for (int s = 0; s < n; ++s) {
+            for (int b = firstBand; b < kNumBands; ++b) {
+                output.at(0, b, start + s) = bands[0][b][s];
+                output.at(1, b, start + s) = bands[1][b][s];
+            }
+        }
+    }
+}
+
+template <typename Output>
+void parallel(BiquadBank<kNumBands> (*sections)[2], const float* inputL, const float* inputR,
+              int numSamples, const Output& output) {
+    // One 8-lane bank per section and channel, lane = band
+    const float* inputs[2] = {inputL, inputR};
+
+    for (int ch = 0; ch < 2; ++ch) {
+        auto highPass = sections[ch][0].load();
+        auto lowPass = sections[ch][1].load();
+
+        const float* input = inputs[ch];
+        alignas(32) float frame[kNumBands];
+
+        for (int s = 0; s < numSamples; ++s) {
+            Float8 y = lowPass.process(highPass.process(Float8::broadcast(input[s])));
+            y.store(frame);
+            for (int b = 0; b < kNumBands; ++b)
+                output.at(ch, b, s) = frame[b];
+        }
+
+        sections[ch][0].store(highPass);
+        sections[ch][1].store(lowPass);
+    }
+}
+
+void filterBankCascade(BiquadBank<4>* stages, const float* inputL, const float* inputR,
+                       int numSamples, const BandOutputs& outputs) {
+    withOutput(outputs, [&](const auto& output) { cascade(stages, inputL, inputR, numSamples, output); });
+}
+
+void filterBankParallel(BiquadBank<kNumBands> (*sections)[2], const float* inputL,
+                        const float* inputR, int numSamples, const BandOutputs& outputs) {
+    withOutput(outputs, [&](const auto& output) { parallel(sections, inputL, inputR, numSamples, output); });
+}
+
+void filterBankTimeParallel(BlockBiquadBank<2> (*stages)[2], const float* inputL,
+                            const float* inputR, int numSamples, const BandOutputs& outputs) {
+    withOutput(outputs, [&](const auto& output) {
+        cascadeTimeParallel(stages, inputL, inputR, numSamples, output);
+    });
+}
+
+// ===== AnalysisBank =====
+
+// Raw azimuth as in AnalysisBand: atan2(|R|-|L|, |R|+|L|) * 2, 0 for silence.
+// atan2(diff, sum) == atan(diff / sum) because sum >= 0.
+inline Float8 rawAzimuth(Float8 l, Float8 r) {
+    const Float8 epsilon = Float8::broadcast(kEpsilon);
+    Float8 absL = abs(l);
+    Float8 absR = abs(r);
+    Float8 azSum = absR + absL;
+    Float8 azDiff = absR - absL;
+    Float8 azimuth = fast::atanUnit(azDiff / max(azSum, epsilon)) * Float8::broadcast(2.0f);
+    return selectGreater(azSum, epsilon, azimuth, Float8::broadcast(0.0f));
+}
+
+// clamp(LR / sqrt(LL * RR), 0, 1), 0 when the denominator vanishes
+inline Float8 rawICC(Float8 ll, Float8 rr, Float8 lr) {
+    const Float8 zero = Float8::broadcast(0.0f);
+    const Float8 epsilon = Float8::broadcast(kEpsilon);
+    Float8 denom = sqrt(ll * rr);
+    Float8 icc = selectGreater(denom, epsilon, lr / max(denom, epsilon), zero);
+    return min(max(icc, zero), Float8::broadcast(1.0f));
+}
+
+void analysisProcessBlock(AnalysisBankState& state, const float* bandL, const float* bandR,
+                          int numSamples, float* icc, float* azimuth, float* energies) {
+    const Float8 energyAlpha = Float8::broadcast(state.energyAlpha);
+    const Float8 iccAlpha = Float8::broadcast(state.iccAlpha);
+    const Float8 azimuthAlpha = Float8::broadcast(state.azimuthAlpha);
+
+    Float8 energyS = Float8::load(state.energySmooth);
+    Float8 llS = Float8::load(state.smoothLL);
+    Float8 rrS = Float8::load(state.smoothRR);
+    Float8 lrS = Float8::load(state.smoothLR);
+    Float8 iccS = Float8::load(state.iccSmooth);
+    Float8 azS = Float8::load(state.azimuthSmooth);
+
+    for (int s = 0; s < numSamples; ++s) {
+        // Same update order as AnalysisBand::process
+        Float8 l = Float8::load(bandL + s * kNumBands);
+        Float8 r = Float8::load(bandR + s * kNumBands);
+
+        energyS = energyS + energyAlpha * ((l * l + r * r) - energyS);
+
+        llS = llS + iccAlpha * (l * l - llS);
+        rrS = rrS + iccAlpha * (r * r - rrS);
+        lrS = lrS + iccAlpha * (l * r - lrS);
+        iccS = iccS + iccAlpha * (rawICC(llS, rrS, lrS) - iccS);
+
+        azS = azS + azimuthAlpha * (rawAzimuth(l, r) - azS);
+
+        // Energy-weighted aggregate over the bands
+        float totalEnergy = kEpsilon + energyS.sum();
+        icc[s] = (energyS * iccS).sum() / totalEnergy;
+        azimuth[s] = (energyS * azS).sum() / totalEnergy;
+        energyS.store(energies + s * kNumBands);
+    }
+
+    energyS.store(state.energySmooth);
+    llS.store(state.smoothLL);
+    rrS.store(state.smoothRR);
+    lrS.store(state.smoothLR);
+    iccS.store(state.iccSmooth);
+    azS.store(state.azimuthSmooth);
+}
+
+void analysisAccumulate(AnalysisBankState& state, const float* bandL, const float* bandR,
+                        int numSamples) {
+    const Float8 energyAlpha = Float8::broadcast(state.energyAlpha);
+    const Float8 iccAlpha = Float8::broadcast(state.iccAlpha);
+
+    Float8 energyS = Float8::load(state.energySmooth);
+    Float8 llS = Float8::load(state.smoothLL);
+    Float8 rrS = Float8::load(state.smoothRR);
+    Float8 lrS = Float8::load(state.smoothLR);
+    Float8 azSumAcc = Float8::load(state.azimuthSum);
+
+    for (int s = 0; s < numSamples; ++s) {
+        Float8 l = Float8::load(bandL + s * kNumBands);
+        Float8 r = Float8::load(bandR + s * kNumBands);
+
+        energyS = energyS + energyAlpha * ((l * l + r * r) - energyS);
+        llS = llS + iccAlpha * (l * l - llS);
+        rrS = rrS + iccAlpha * (r * r - rrS);
+        lrS = lrS + iccAlpha * (l * r - lrS);
+        azSumAcc = azSumAcc + rawAzimuth(l, r);
+    }
+
+    energyS.store(state.energySmooth);
+    llS.store(state.smoothLL);
+    rrS.store(state.smoothRR);
+    lrS.store(state.smoothLR);
+    azSumAcc.store(state.azimuthSum);
+    state.numAccumulated += numSamples;
+}
+
+void analysisUpdateControl(AnalysisBankState& state, float& icc, float& azimuth, float* energies) {
+    const Float8 zero = Float8::broadcast(0.0f);
+    Float8 energyS = Float8::load(state.energySmooth);
+
+    Float8 iccS = Float8::load(state.iccSmooth);
+    Float8 iccRaw = rawICC(Float8::load(state.smoothLL), Float8::load(state.smoothRR),
+                           Float8::load(state.smoothLR));
+    iccS = iccS + Float8::broadcast(state.iccAlphaControl) * (iccRaw - iccS);
+
+    // Mean raw azimuth over the interval
+    Float8 azS = Float8::load(state.azimuthSmooth);
+    Float8 azMean = (state.numAccumulated > 0)
+        ? Float8::load(state.azimuthSum) * Float8::broadcast(1.0f / static_cast<float>(state.numAccumulated))
+        : zero;
+    azS = azS + Float8::broadcast(state.azimuthAlphaControl) * (azMean - azS);
+
+    iccS.store(state.iccSmooth);
+    azS.store(state.azimuthSmooth);
+    zero.store(state.azimuthSum);
+    state.numAccumulated = 0;
+
+    float totalEnergy = kEpsilon + energyS.sum();
+    icc = (energyS * iccS).sum() / totalEnergy;
+    azimuth = (energyS * azS).sum() / totalEnergy;
+    energyS.store(energies);
+}
+
+// ===== AmbisonicDecoder =====
+// One kernel per layout, generated from its constexpr matrix: every speaker
+// row keeps only its non-zero terms (in W, X, Y, Z order, so the sums match
+// the full matrix product), a single unit term becomes a copy, and the LFE
+// row is left to the LFE pass.
+
+constexpr bool isZero(float c) { return !(c > 0.0f) && !(c < 0.0f); }
+constexpr bool isOne(float c) { return !(c > 1.0f) && !(c < 1.0f); }
+
+struct RowTerms {
+    int count = 0;
+    int channel[kNumAmbiChannels] = {};
+    float coeff[kNumAmbiChannels] = {};
+};
+
+constexpr RowTerms getRowTerms(const float* row) {
+    RowTerms terms;
+    for (int ch = 0; ch < kNumAmbiChannels; ++ch) {
+        if (!isZero(row[ch])) {
+            terms.channel[terms.count] = ch;
+            terms.coeff[terms.count] = row[ch];
+            ++terms.count;
+        }
+    }
+    return terms;
+}
+
+template <SpeakerLayout Layout, int Spk>
+constexpr RowTerms kRowTerms =
+    getRowTerms(kLayoutInfos[static_cast<int>(Layout)].decoderMatrix + Spk * kNumAmbiChannels);
+
+template <SpeakerLayout Layout, int Spk>
+constexpr bool kIsLfeRow = Spk == kLayoutInfos[static_cast<int>(Layout)].lfeChannelIndex;
+
+// Block kernel for one speaker row, optionally scaled by a per-sample gain
+template <SpeakerLayout Layout, int Spk>
+void decodeRow(const float* const* bFormat, int numSamples, const float* gain, float* out) {
+    constexpr RowTerms terms = kRowTerms<Layout, Spk>;
+
+    if constexpr (kIsLfeRow<Layout, Spk>) {
+        return;
+    } else if constexpr (terms.count == 0) {
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = 0.0f;
+    } else {
+        const float* in0 = bFormat[terms.channel[0]];
+        const float* in1 = bFormat[terms.channel[terms.count > 1 ? 1 : 0]];
+        const float* in2 = bFormat[terms.channel[terms.count > 2 ? 2 : 0]];
+        const float* in3 = bFormat[terms.channel[terms.count > 3 ? 3 : 0]];
+        auto rowSum = [&](int i) {
+            float sum = terms.coeff[0] * in0[i];
+            if constexpr (terms.count > 1) sum += terms.coeff[1] * in1[i];
+            if constexpr (terms.count > 2) sum += terms.coeff[2] * in2[i];
+            if constexpr (terms.count > 3) sum += terms.coeff[3] * in3[i];
+            return sum;
+        };
+
+        if (gain != nullptr) {
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = rowSum(i) * gain[i];
+        } else if constexpr (terms.count == 1 && isOne(terms.coeff[0])) {
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = in0[i];
+        } else {
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = rowSum(i);
+        }
+    }
+}
+
+// Single-frame kernel for one speaker row
+template <SpeakerLayout Layout, int Spk>
+void decodeFrameRow(const float* frame, float* speakerOutputs) {
+    constexpr RowTerms terms = kRowTerms<Layout, Spk>;
+
+    if constexpr (kIsLfeRow<Layout, Spk>) {
+        return;
+    } else if constexpr (terms.count == 0) {
+        speakerOutputs[Spk] = 0.0f;
+    } else {
+        float sum = terms.coeff[0] * frame[terms.channel[0]];
+        if constexpr (terms.count > 1) sum += terms.coeff[1] * frame[terms.channel[1]];
+        if constexpr (terms.count > 2) sum += terms.coeff[2] * frame[terms.channel[2]];
+        if constexpr (terms.count > 3) sum += terms.coeff[3] * frame[terms.channel[3]];
+        speakerOutputs[Spk] = sum;
+    }
+}
+
+// Calls fn.template operator()<Layout>() for the runtime layout
+template <typename Fn>
+void dispatchLayout(SpeakerLayout layout, Fn&& fn) {
+    switch (layout) {
+        case SpeakerLayout::Stereo:
+            fn.template operator()<SpeakerLayout::Stereo>();
+            break;
+        case SpeakerLayout::Surround714:
+            fn.template operator()<SpeakerLayout::Surround714>();
+            break;
+        case SpeakerLayout::Surround916:
+            fn.template operator()<SpeakerLayout::Surround916>();
+            break;
+        case SpeakerLayout::Surround222:
+            fn.template operator()<SpeakerLayout::Surround222>();
+            break;
+        case SpeakerLayout::AmbiX:
+            fn.template operator()<SpeakerLayout::AmbiX>();
+            break;
+        case SpeakerLayout::Surround51:
+        case SpeakerLayout::kNumLayouts:
+        default:  // same fallback as getLayoutInfo()
+            fn.template operator()<SpeakerLayout::Surround51>();
+            break;
+    }
+}
+
+// Decodes the first numCh speakers (the LFE row and null outputs excepted)
+// over a block
+void decodeBlock(SpeakerLayout layout, const float* const* bFormat, int numSamples,
+                 const float* gain, float* const* speakerOutputs, int numCh) {
+    dispatchLayout(layout, [&]<SpeakerLayout Layout>() {
+        constexpr int kNumSpeakers = kLayoutInfos[static_cast<int>(Layout)].numChannels;
+        [&]<int... Spk>(std::integer_sequence<int, Spk...>) {
+            ((Spk < numCh && speakerOutputs[Spk] != nullptr ? decodeRow<Layout, Spk>(bFormat, numSamples, gain, speakerOutputs[Spk]) : void()), ...);
+        }(std::make_integer_sequence<int, kNumSpeakers>{});
+    });
+}
+
+// Decodes every speaker of the layout (the LFE row excepted) for one frame
+void decodeFrame(SpeakerLayout layout, const float* frame, float* speakerOutputs) {
+    dispatchLayout(layout, [&]<SpeakerLayout Layout>() {
+        constexpr int kNumSpeakers = kLayoutInfos[static_cast<int>(Layout)].numChannels;
+        [&]<int... Spk>(std::integer_sequence<int, Spk...>) {
+            (decodeFrameRow<Layout, Spk>(frame, speakerOutputs), ...);
+        }(std::make_integer_sequence<int, kNumSpeakers>{});
+    });
+}
+
+// ===== OutputWriter =====
+
+void applyGain(const float* input, const float* gain, float* output, int numSamples) {
+    for (int s = 0; s < numSamples; ++s)
+        output[s] = input[s] * gain[s];
+}
+
+void applyConstantGain(const float* input, float gain, float* output, int numSamples) {
+    for (int s = 0; s < numSamples; ++s)
+        output[s] = input[s] * gain;
+}
+
+}  // namespace
+
+const SimdKernels& getKernelTable();
+
+const SimdKernels& getKernelTable() {
+    static constexpr SimdKernels kKernels = {
+        .level = SimdLevel::UPMIXRT_SIMD_KERNEL_LEVEL,
+        .filterBankCascade = filterBankCascade,
+        .filterBankParallel = filterBankParallel,
+        .filterBankTimeParallel = filterBankTimeParallel,
+        .analysisProcessBlock = analysisProcessBlock,
+        .analysisAccumulate = analysisAccumulate,
+        .analysisUpdateControl = analysisUpdateControl,
+        .decodeBlock = decodeBlock,
+        .decodeFrame = decodeFrame,
+        .applyGain = applyGain,
+        .applyConstantGain = applyConstantGain,
+    };
+    return kKernels;
+}
+
+}  // namespace UPMIXRT_SIMD_NAMESPACE
+}  // namespace audio_plugin
+
+#endif
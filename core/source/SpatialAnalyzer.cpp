@@ -0,0 +1,318 @@
+#include <UpmixRT/SpatialAnalyzer.h>
+#include <UpmixRT/FastMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+enum ScratchChannel {
+    kFramesL, kFramesR, kEnergies, kICC, kAzimuth,
+    kLowFramesL, kLowFramesR, kBaseL, kBaseR, kLowL, kLowR,
+    kNumScratchChannels
+};
+
+// What the per-sample analysis outputs for silence: no correlation, so
+// fully diffuse. The control-rate ramps start from here.
+constexpr SpatialParams kSilentParams{0.0f, 0.0f, 1.0f, 0.0f};
+
+}  // namespace
+
+void SpatialAnalyzer::prepare(double sampleRate, const AnalysisConfig& config,
+                              const SimdKernels& kernels) {
+    controlInterval_ = std::max(1, config.controlInterval);
+    engine_ = config.engine;
+    multirate_ = config.multirate && engine_ == AnalysisEngine::FilterBank;
+
+    if (engine_ == AnalysisEngine::Stft) {
+        stft_.prepare(sampleRate, config.stftNumBands, config.stftBandScale);
+        controlInterval_ = stft_.getHopSize();
+    } else if (multirate_) {
+        numRateStages_ = 0;
+        while (numRateStages_ < kMaxRateStages
+               && sampleRate / (1 << numRateStages_) > static_cast<double>(kMultirateMaxBaseRate))
+            ++numRateStages_;
+        baseFactor_ = 1 << numRateStages_;
+        lowFactor_ = baseFactor_ << kMultirateLowBandStages;
+
+        // Updates fall on low-band samples, so both banks have just stepped
+        controlInterval_ = (controlInterval_ + lowFactor_ - 1) / lowFactor_ * lowFactor_;
+
+        // Only the stage into the base rate keeps content up to 0.4 x that
+        // rate (the upper bands); the others are decimated again or, for
+        // the low bands, only needed far below their Nyquist frequency
+        for (int i = 0; i < numRateStages_; ++i)
+            rateDecimators_[i].prepare(i == numRateStages_ - 1 ? HalfBandDesign::Sharp
+                                                                : HalfBandDesign::Wide);
+        for (auto& decimator : lowDecimators_)
+            decimator.prepare(HalfBandDesign::Wide);
+
+        double baseRate = sampleRate / baseFactor_;
+        double lowRate = sampleRate / lowFactor_;
+        filterBank_.prepareBands(baseRate, kMultirateNumLowBands, kNumBands, kernels);
+        lowFilterBank_.prepareBands(lowRate, 0, kMultirateNumLowBands, kernels);
+        bank_.prepare(baseRate, controlInterval_ / baseFactor_, kernels);
+        lowBank_.prepare(lowRate, controlInterval_ / lowFactor_, kernels);
+    } else {
+        filterBank_.prepare(sampleRate, config.filterBankTopology, kernels);
+        bank_.prepare(sampleRate, controlInterval_, kernels);
+    }
+    heightEstimator_.prepare(sampleRate, controlInterval_);
+    scratch_.allocate(kNumScratchChannels, kSubBlockSize * kNumBands);
+    reset();
+}
+
+void SpatialAnalyzer::reset() {
+    filterBank_.reset();
+    bank_.reset();
+    heightEstimator_.reset();
+    for (auto& decimator : rateDecimators_)
+        decimator.reset();
+    for (auto& decimator : lowDecimators_)
+        decimator.reset();
+    lowFilterBank_.reset();
+    lowBank_.reset();
+    if (engine_ == AnalysisEngine::Stft)
+        stft_.reset();
+    controlPhase_ = 0;
+    current_ = kSilentParams;
+    step_ = SpatialParams{};
+}
+
+SpatialParams SpatialAnalyzer::process(float inputL, float inputR) {
+    SpatialParams params;
+    processBlock(&inputL, &inputR, 1, &params);
+    return params;
+}
+
+int SpatialAnalyzer::getTailSamples(float threshold) const {
+    if (engine_ == AnalysisEngine::Stft)
+        return stft_.getFftSize();
+    if (!multirate_)
+        return filterBank_.getTailSamples(threshold);
+
+    // Each bank's tail at its own rate, after the half-band delay lines,
+    // which together hold less than kHalfBandMaxLength low-band samples
+    return std::max(filterBank_.getTailSamples(threshold) * baseFactor_,
+                    lowFilterBank_.getTailSamples(threshold) * lowFactor_)
+           + kHalfBandMaxLength * lowFactor_;
+}
+
+int SpatialAnalyzer::getLatencySamples() const {
+    return engine_ == AnalysisEngine::Stft ? stft_.getLatencySamples() : 0;
+}
+
+SpatialParams SpatialAnalyzer::makeParams(float icc, float azimuth, const float* bandEnergies) {
+    float diffuseness = hot::sqrt(1.0f - std::clamp(icc, 0.0f, 1.0f));
+    float elevation = heightEstimator_.process(bandEnergies);
+    return SpatialParams{icc, azimuth, diffuseness, elevation};
+}
+
+void SpatialAnalyzer::processBlock(const float* inputL, const float* inputR, int numSamples,
+                                   SpatialParams* params) {
+    // Multirate sub-blocks hold kSubBlockSize base-rate samples
+    const int subBlockSize = multirate_ ? kSubBlockSize * baseFactor_ : kSubBlockSize;
+    for (int start = 0; start < numSamples; start += subBlockSize) {
+        int n = std::min(subBlockSize, numSamples - start);
+        if (engine_ == AnalysisEngine::Stft)
+            processSubBlockStft(inputL + start, inputR + start, n, params + start);
+        else if (multirate_)
+            processSubBlockMultirate(inputL + start, inputR + start, n, params + start);
+        else if (controlInterval_ > 1)
+            processSubBlockControlRate(inputL + start, inputR + start, n, params + start);
+        else
+            processSubBlock(inputL + start, inputR + start, n, params + start);
+    }
+}
+
+void SpatialAnalyzer::processSubBlock(const float* inputL, const float* inputR, int numSamples,
+                                      SpatialParams* params) {
+    float* framesL = scratch_.getChannel(kFramesL);
+    float* framesR = scratch_.getChannel(kFramesR);
+    float* energies = scratch_.getChannel(kEnergies);
+    float* icc = scratch_.getChannel(kICC);
+    float* azimuth = scratch_.getChannel(kAzimuth);
+
+    filterBank_.processBlockInterleaved(inputL, inputR, numSamples, framesL, framesR);
+    bank_.processBlock(framesL, framesR, numSamples, icc, azimuth, energies);
+
+    for (int s = 0; s < numSamples; ++s)
+        params[s] = makeParams(icc[s], azimuth[s], energies + s * kNumBands);
+}
+
+void SpatialAnalyzer::processSubBlockControlRate(const float* inputL, const float* inputR,
+                                                 int numSamples, SpatialParams* params) {
+    float* framesL = scratch_.getChannel(kFramesL);
+    float* framesR = scratch_.getChannel(kFramesR);
+
+    filterBank_.processBlockInterleaved(inputL, inputR, numSamples, framesL, framesR);
+
+    // Split the sub-block at control-rate update points
+    int s = 0;
+    while (s < numSamples) {
+        int n = std::min(controlInterval_ - controlPhase_, numSamples - s);
+
+        bank_.accumulate(framesL + s * kNumBands, framesR + s * kNumBands, n);
+        advanceControl(params + s, n);
+
+        s += n;
+        controlPhase_ += n;
+
+        if (controlPhase_ == controlInterval_) {
+            controlPhase_ = 0;
+
+            float icc = 0.0f;
+            float azimuth = 0.0f;
+            float bandEnergies[kNumBands];
+            bank_.updateControl(icc, azimuth, bandEnergies);
+            setControlTarget(makeParams(icc, azimuth, bandEnergies));
+        }
+    }
+}
+
+void SpatialAnalyzer::processSubBlockMultirate(const float* inputL, const float* inputR,
+                                               int numSamples, SpatialParams* params) {
+    float* framesL = scratch_.getChannel(kFramesL);
+    float* framesR = scratch_.getChannel(kFramesR);
+    float* lowFramesL = scratch_.getChannel(kLowFramesL);
+    float* lowFramesR = scratch_.getChannel(kLowFramesR);
+    float* baseL = scratch_.getChannel(kBaseL);
+    float* baseR = scratch_.getChannel(kBaseR);
+    float* lowL = scratch_.getChannel(kLowL);
+    float* lowR = scratch_.getChannel(kLowR);
+
+    // Host rate -> base rate, kSubBlockSize host samples at a time, every
+    // stage in place at the end of the base-rate samples so far; at most
+    // kSubBlockSize come out. Spans below use up exactly the numBase and
+    // numLow samples made here.
+    const float* bandInputL = inputL;
+    const float* bandInputR = inputR;
+    int numBase = numSamples;
+    if (numRateStages_ > 0) {
+        numBase = 0;
+        for (int start = 0; start < numSamples; start += kSubBlockSize) {
+            const float* stageL = inputL + start;
+            const float* stageR = inputR + start;
+            int n = std::min(kSubBlockSize, numSamples - start);
+            for (int i = 0; i < numRateStages_; ++i) {
+                n = rateDecimators_[i].processBlock(stageL, stageR, n, baseL + numBase, baseR + numBase);
+                stageL = baseL + numBase;
+                stageR = baseR + numBase;
+            }
+            numBase += n;
+        }
+        bandInputL = baseL;
+        bandInputR = baseR;
+    }
+
+    // Base rate -> low-band rate
+    int numLow = numBase;
+    const float* lowInputL = bandInputL;
+    const float* lowInputR = bandInputR;
+    for (auto& decimator : lowDecimators_) {
+        numLow = decimator.processBlock(lowInputL, lowInputR, numLow, lowL, lowR);
+        lowInputL = lowL;
+        lowInputR = lowR;
+    }
+
+    filterBank_.processBlockInterleaved(bandInputL, bandInputR, numBase, framesL, framesR);
+    lowFilterBank_.processBlockInterleaved(lowL, lowR, numLow, lowFramesL, lowFramesR);
+
+    // Split at update points. A decimated sample comes out on every
+    // baseFactor_-th (lowFactor_-th) host sample, and the control interval
+    // is a multiple of both, so the phase says how many fall in a span.
+    int s = 0;
+    int base = 0;
+    int low = 0;
+    while (s < numSamples) {
+        int n = std::min(controlInterval_ - controlPhase_, numSamples - s);
+        int phaseEnd = controlPhase_ + n;
+        int numBaseSpan = phaseEnd / baseFactor_ - controlPhase_ / baseFactor_;
+        int numLowSpan = phaseEnd / lowFactor_ - controlPhase_ / lowFactor_;
+
+        bank_.accumulate(framesL + base * kNumBands, framesR + base * kNumBands, numBaseSpan);
+        lowBank_.accumulate(lowFramesL + low * kNumBands, lowFramesR + low * kNumBands, numLowSpan);
+        advanceControl(params + s, n);
+
+        s += n;
+        base += numBaseSpan;
+        low += numLowSpan;
+        controlPhase_ = phaseEnd;
+
+        if (controlPhase_ == controlInterval_) {
+            controlPhase_ = 0;
+
+            // Every band lives in one of the banks, with zeros in the
+            // other: energies add, and the two energy-weighted aggregates
+            // combine weighted by their banks' total energy
+            float iccUpper = 0.0f, azimuthUpper = 0.0f;
+            float iccLow = 0.0f, azimuthLow = 0.0f;
+            float energiesUpper[kNumBands];
+            float energiesLow[kNumBands];
+            bank_.updateControl(iccUpper, azimuthUpper, energiesUpper);
+            lowBank_.updateControl(iccLow, azimuthLow, energiesLow);
+
+            float bandEnergies[kNumBands];
+            float totalUpper = 0.0f;
+            float totalLow = 0.0f;
+            for (int b = 0; b < kNumBands; ++b) {
+                bandEnergies[b] = energiesUpper[b] + energiesLow[b];
+                totalUpper += energiesUpper[b];
+                totalLow += energiesLow[b];
+            }
+            float weightUpper = kEpsilon + totalUpper;
+            float weightLow = kEpsilon + totalLow;
+            float invTotal = 1.0f / (kEpsilon + totalUpper + totalLow);
+            float icc = (iccUpper * weightUpper + iccLow * weightLow) * invTotal;
+            float azimuth = (azimuthUpper * weightUpper + azimuthLow * weightLow) * invTotal;
+            setControlTarget(makeParams(icc, azimuth, bandEnergies));
+        }
+    }
+}
+
+void SpatialAnalyzer::processSubBlockStft(const float* inputL, const float* inputR,
+                                          int numSamples, SpatialParams* params) {
+    // Split the sub-block at hop boundaries
+    int s = 0;
+    while (s < numSamples) {
+        int n = std::min(controlInterval_ - controlPhase_, numSamples - s);
+
+        stft_.push(inputL + s, inputR + s, n);
+        advanceControl(params + s, n);
+
+        s += n;
+        controlPhase_ += n;
+
+        if (controlPhase_ == controlInterval_) {
+            controlPhase_ = 0;
+
+            float icc = 0.0f;
+            float azimuth = 0.0f;
+            float bandEnergies[kNumBands];
+            stft_.analyse(icc, azimuth, bandEnergies);
+            setControlTarget(makeParams(icc, azimuth, bandEnergies));
+        }
+    }
+}
+
+void SpatialAnalyzer::advanceControl(SpatialParams* params, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        current_.icc += step_.icc;
+        current_.azimuth += step_.azimuth;
+        current_.diffuseness += step_.diffuseness;
+        current_.elevation += step_.elevation;
+        params[i] = current_;
+    }
+}
+
+void SpatialAnalyzer::setControlTarget(const SpatialParams& target) {
+    // Ramp from where the output is now to the new target
+    float invInterval = 1.0f / static_cast<float>(controlInterval_);
+    step_.icc = (target.icc - current_.icc) * invInterval;
+    step_.azimuth = (target.azimuth - current_.azimuth) * invInterval;
+    step_.diffuseness = (target.diffuseness - current_.diffuseness) * invInterval;
+    step_.elevation = (target.elevation - current_.elevation) * invInterval;
+}
+
+}  // namespace audio_plugin
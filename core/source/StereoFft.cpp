@@ -0,0 +1,103 @@
+#include <UpmixRT/StereoFft.h>
+#include <UpmixRT/Constants.h>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+// Butterflies of one group: (x0, x1) <- (x0 + w x1, x0 - w x1) for n pairs
+void butterflyRun(float* __restrict re0, float* __restrict im0, float* __restrict re1,
+                  float* __restrict im1, const float* __restrict wr, const float* __restrict wi,
+                  int n) {
+    for (int j = 0; j < n; ++j) {
+        float tr = re1[j] * wr[j] - im1[j] * wi[j];
+        float ti = re1[j] * wi[j] + im1[j] * wr[j];
+        re1[j] = re0[j] - tr;
+        im1[j] = im0[j] - ti;
+        re0[j] += tr;
+        im0[j] += ti;
+    }
+}
+
+}  // namespace
+
+void StereoFft::prepare(int size) {
+    size_ = size;
+
+    int numBits = 0;
+    while ((1 << numBits) < size_)
+        ++numBits;
+    bitReverse_.assign(static_cast<size_t>(size_), 0);
+    for (int i = 0; i < size_; ++i) {
+        int reversed = 0;
+        for (int bit = 0; bit < numBits; ++bit)
+            reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+        bitReverse_[static_cast<size_t>(i)] = reversed;
+    }
+
+    twiddleCos_.assign(static_cast<size_t>(size_ - 1), 0.0f);
+    twiddleSin_.assign(static_cast<size_t>(size_ - 1), 0.0f);
+    for (int half = 1; half < size_; half *= 2) {
+        for (int j = 0; j < half; ++j) {
+            double angle = -static_cast<double>(kPi) * j / half;
+            twiddleCos_[static_cast<size_t>(half - 1 + j)] = static_cast<float>(std::cos(angle));
+            twiddleSin_[static_cast<size_t>(half - 1 + j)] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    work_.allocate(2, size_);
+}
+
+void StereoFft::transform(const float* inputL, const float* inputR,
+                          float* realL, float* imagL, float* realR, float* imagR) {
+    float* re = work_.getChannel(0);
+    float* im = work_.getChannel(1);
+    const int* bitReverse = bitReverse_.data();
+
+    // z = L + iR, in bit-reversed order
+    for (int i = 0; i < size_; ++i) {
+        re[i] = inputL[bitReverse[i]];
+        im[i] = inputR[bitReverse[i]];
+    }
+
+    // Decimation-in-time butterflies. The first two stages (twiddles 1 and
+    // -i) run together as one radix-4 pass without multiplies.
+    for (int start = 0; start < size_; start += 4) {
+        float* r = re + start;
+        float* i = im + start;
+        float ar = r[0] + r[1], ai = i[0] + i[1];
+        float br = r[0] - r[1], bi = i[0] - i[1];
+        float cr = r[2] + r[3], ci = i[2] + i[3];
+        float dr = r[2] - r[3], di = i[2] - i[3];
+        r[0] = ar + cr;
+        i[0] = ai + ci;
+        r[2] = ar - cr;
+        i[2] = ai - ci;
+        r[1] = br + di;  // b - i d
+        i[1] = bi - dr;
+        r[3] = br - di;
+        i[3] = bi + dr;
+    }
+    for (int half = 4; half < size_; half *= 2) {
+        const float* wr = twiddleCos_.data() + half - 1;
+        const float* wi = twiddleSin_.data() + half - 1;
+        for (int start = 0; start < size_; start += 2 * half)
+            butterflyRun(re + start, im + start, re + start + half, im + start + half, wr, wi, half);
+    }
+
+    // Z[k] = L[k] + i R[k] with L and R Hermitian:
+    // L[k] = (Z[k] + conj(Z[N - k])) / 2, R[k] = (Z[k] - conj(Z[N - k])) / 2i
+    const int numBins = size_ / 2 + 1;
+    for (int k = 0; k < numBins; ++k) {
+        int mirror = (size_ - k) & (size_ - 1);
+        float a = re[k], b = im[k];
+        float c = re[mirror], d = im[mirror];
+        realL[k] = 0.5f * (a + c);
+        imagL[k] = 0.5f * (b - d);
+        realR[k] = 0.5f * (b + d);
+        imagR[k] = 0.5f * (c - a);
+    }
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,188 @@
+#include <UpmixRT/StftAnalyzer.h>
+#include <UpmixRT/AnalysisBand.h>
+#include <UpmixRT/FastMath.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+enum ScratchChannel { kWindowedL, kWindowedR, kRealL, kImagL, kRealR, kImagR, kNumScratchChannels };
+
+double toScale(BandScale scale, double frequency) {
+    if (scale == BandScale::Erb)
+        return 21.4 * std::log10(1.0 + 0.00437 * frequency);
+    return 26.81 * frequency / (1960.0 + frequency) - 0.53;
+}
+
+double fromScale(BandScale scale, double value) {
+    if (scale == BandScale::Erb)
+        return (std::pow(10.0, value / 21.4) - 1.0) / 0.00437;
+    return 1960.0 * (value + 0.53) / (26.28 - value);
+}
+
+}  // namespace
+
+void StftAnalyzer::prepare(double sampleRate, int numBands, BandScale scale) {
+    int fftSize = 4;
+    while (fftSize < sampleRate * static_cast<double>(kStftWindowSec))
+        fftSize *= 2;
+    fft_.prepare(fftSize);
+    hopSize_ = fftSize / kStftHopDivisor;
+    numBands_ = std::clamp(numBands, 1, kStftMaxBands);
+    const int numBins = fftSize / 2 + 1;
+
+    // Periodic Hann window; a bin's power is scaled so that a band's sum is
+    // the mean power per sample of the band-limited input, as the filter
+    // bank's energies are
+    window_.assign(static_cast<size_t>(fftSize), 0.0f);
+    double windowPower = 0.0;
+    for (int n = 0; n < fftSize; ++n) {
+        double w = 0.5 - 0.5 * std::cos(2.0 * static_cast<double>(kPi) * n / fftSize);
+        window_[static_cast<size_t>(n)] = static_cast<float>(w);
+        windowPower += w * w;
+    }
+    float scaleOneSided = static_cast<float>(2.0 / (fftSize * windowPower));
+    binScale_.assign(static_cast<size_t>(numBins), scaleOneSided);
+    binScale_.front() *= 0.5f;
+    binScale_.back() *= 0.5f;
+
+    // Band edges evenly spaced on the scale from 0 Hz to the top frequency;
+    // a bin belongs to the band its centre frequency falls in
+    const double binWidth = sampleRate / fftSize;
+    const double topFrequency = std::min(static_cast<double>(kStftMaxBandFrequency), sampleRate / 2.0);
+    const double low = toScale(scale, 0.0);
+    const double high = toScale(scale, topFrequency);
+    auto firstBinFrom = [&](double frequency, int minBin) {
+        int bin = static_cast<int>(std::ceil(frequency / binWidth));
+        return std::clamp(bin, minBin, numBins);
+    };
+    bandStart_[0] = 0;
+    for (int b = 1; b < numBands_; ++b) {
+        double edge = fromScale(scale, low + (high - low) * b / numBands_);
+        bandStart_[b] = firstBinFrom(edge, bandStart_[b - 1]);
+    }
+    bandStart_[numBands_] = numBins;
+
+    crossoverStart_[0] = 0;
+    for (int c = 1; c < kNumBands; ++c)
+        crossoverStart_[c] = firstBinFrom(static_cast<double>(kCrossoverFreqs[c - 1]), crossoverStart_[c - 1]);
+    crossoverStart_[kNumBands] = numBins;
+
+    // The band smoothers, advanced a hop at a time
+    iccAlpha_ = smoothingAlpha(sampleRate, kICCSmoothingTimeSec, hopSize_);
+    azimuthAlpha_ = smoothingAlpha(sampleRate, kAzimuthSmoothingTimeSec, hopSize_);
+    energyAlpha_ = smoothingAlpha(sampleRate, kEnergySmoothingTimeSec, hopSize_);
+
+    frame_.allocate(2, fftSize);
+    scratch_.allocate(kNumScratchChannels, fftSize);
+    reset();
+}
+
+void StftAnalyzer::reset() {
+    frame_.clear();
+    numFilled_ = 0;
+    std::fill(std::begin(iccSmooth_), std::end(iccSmooth_), 0.0f);
+    std::fill(std::begin(azimuthSmooth_), std::end(azimuthSmooth_), 0.0f);
+    std::fill(std::begin(energySmooth_), std::end(energySmooth_), 0.0f);
+    std::fill(std::begin(crossoverEnergySmooth_), std::end(crossoverEnergySmooth_), 0.0f);
+    std::fill(std::begin(smoothLL_), std::end(smoothLL_), 0.0f);
+    std::fill(std::begin(smoothRR_), std::end(smoothRR_), 0.0f);
+    std::fill(std::begin(smoothLR_), std::end(smoothLR_), 0.0f);
+}
+
+void StftAnalyzer::push(const float* inputL, const float* inputR, int numSamples) {
+    int offset = getFftSize() - hopSize_ + numFilled_;
+    std::copy(inputL, inputL + numSamples, frame_.getChannel(0) + offset);
+    std::copy(inputR, inputR + numSamples, frame_.getChannel(1) + offset);
+    numFilled_ += numSamples;
+}
+
+void StftAnalyzer::analyse(float& icc, float& azimuth, float* energies) {
+    const int fftSize = getFftSize();
+    const int numBins = fftSize / 2 + 1;
+    float* frameL = frame_.getChannel(0);
+    float* frameR = frame_.getChannel(1);
+    float* windowedL = scratch_.getChannel(kWindowedL);
+    float* windowedR = scratch_.getChannel(kWindowedR);
+    float* realL = scratch_.getChannel(kRealL);
+    float* imagL = scratch_.getChannel(kImagL);
+    float* realR = scratch_.getChannel(kRealR);
+    float* imagR = scratch_.getChannel(kImagR);
+
+    const float* window = window_.data();
+    for (int n = 0; n < fftSize; ++n) {
+        windowedL[n] = frameL[n] * window[n];
+        windowedR[n] = frameR[n] * window[n];
+    }
+    fft_.transform(windowedL, windowedR, realL, imagL, realR, imagR);
+
+    // Keep the overlap for the next hop
+    std::copy(frameL + hopSize_, frameL + fftSize, frameL);
+    std::copy(frameR + hopSize_, frameR + fftSize, frameR);
+    numFilled_ = 0;
+
+    // Per-bin auto- and cross-spectra, into the windowed buffers' place
+    float* powerL = windowedL;
+    float* powerR = windowedR;
+    float* cross = realL;
+    const float* binScale = binScale_.data();
+    for (int k = 0; k < numBins; ++k) {
+        float pl = (realL[k] * realL[k] + imagL[k] * imagL[k]) * binScale[k];
+        float pr = (realR[k] * realR[k] + imagR[k] * imagR[k]) * binScale[k];
+        cross[k] = (realL[k] * realR[k] + imagL[k] * imagR[k]) * binScale[k];
+        powerL[k] = pl;
+        powerR[k] = pr;
+    }
+
+    float totalEnergy = kEpsilon;
+    float iccSum = 0.0f;
+    float azimuthSum = 0.0f;
+    for (int b = 0; b < numBands_; ++b) {
+        float ll = 0.0f, rr = 0.0f, lr = 0.0f;
+        for (int k = bandStart_[b]; k < bandStart_[b + 1]; ++k) {
+            ll += powerL[k];
+            rr += powerR[k];
+            lr += cross[k];
+        }
+
+        energySmooth_[b] += energyAlpha_ * ((ll + rr) - energySmooth_[b]);
+
+        // Covariances smoothed over hops as well: a narrow band has few
+        // bins, and ICC from a single frame is biased up on uncorrelated
+        // input
+        smoothLL_[b] += iccAlpha_ * (ll - smoothLL_[b]);
+        smoothRR_[b] += iccAlpha_ * (rr - smoothRR_[b]);
+        smoothLR_[b] += iccAlpha_ * (lr - smoothLR_[b]);
+
+        float denom = hot::sqrt(smoothLL_[b] * smoothRR_[b]);
+        float iccRaw = (denom > kEpsilon) ? (smoothLR_[b] / denom) : 0.0f;
+        iccRaw = std::clamp(iccRaw, 0.0f, 1.0f);
+        iccSmooth_[b] += iccAlpha_ * (iccRaw - iccSmooth_[b]);
+
+        // Same mapping as the per-sample azimuth, on the frame's band
+        // magnitudes
+        float magL = hot::sqrt(ll);
+        float magR = hot::sqrt(rr);
+        float azSum = magR + magL;
+        float azimuthRaw = (azSum > kEpsilon) ? hot::atan2(magR - magL, azSum) * 2.0f : 0.0f;
+        azimuthSmooth_[b] += azimuthAlpha_ * (azimuthRaw - azimuthSmooth_[b]);
+
+        totalEnergy += energySmooth_[b];
+        iccSum += energySmooth_[b] * iccSmooth_[b];
+        azimuthSum += energySmooth_[b] * azimuthSmooth_[b];
+    }
+    icc = iccSum / totalEnergy;
+    azimuth = azimuthSum / totalEnergy;
+
+    for (int c = 0; c < kNumBands; ++c) {
+        float energy = 0.0f;
+        for (int k = crossoverStart_[c]; k < crossoverStart_[c + 1]; ++k)
+            energy += powerL[k] + powerR[k];
+        crossoverEnergySmooth_[c] += energyAlpha_ * (energy - crossoverEnergySmooth_[c]);
+        energies[c] = crossoverEnergySmooth_[c];
+    }
+}
+
+}  // namespace audio_plugin
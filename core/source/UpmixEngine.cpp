@@ -0,0 +1,153 @@
+#include <UpmixRT/UpmixEngine.h>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#endif
+
+namespace audio_plugin {
+
+namespace {
+
+// Spin iterations before a worker sleeps on the generation counter;
+// keeps wake-up latency low between back-to-back blocks.
+constexpr int kWorkerSpinCount = 4096;
+
+// Flush denormals to zero on worker threads, matching the host audio
+// thread (the plugin uses juce::ScopedNoDenormals).
+void disableDenormals() {
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_setcsr(_mm_getcsr() | 0x8040);  // FTZ | DAZ
+#elif defined(__aarch64__) && defined(__GNUC__)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    asm volatile("msr fpcr, %0" : : "r"(fpcr | (1ull << 24)));  // FZ
+#endif
+}
+
+}  // namespace
+
+UpmixEngine::~UpmixEngine() {
+    release();
+}
+
+void UpmixEngine::prepare(int numStreams, double sampleRate, int maxBlockSize,
+                          SpeakerLayout layout, int numWorkers,
+                          const AnalysisConfig& config, VelvetBudget velvetBudget,
+                          SimdLevel maxSimdLevel) {
+    release();
+
+    numStreams = std::max(0, numStreams);
+    pipelines_.resize(static_cast<size_t>(numStreams));
+    for (auto& pipeline : pipelines_)
+        pipeline.prepare(sampleRate, maxBlockSize, layout, config, velvetBudget, maxSimdLevel);
+
+    if (numWorkers < 0) {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        numWorkers = std::max(0, hardwareThreads - 1);
+    }
+    numWorkers = std::clamp(numWorkers, 0, std::max(0, numStreams - 1));
+
+    numQueues_ = numWorkers + 1;
+    queues_ = std::make_unique<WorkQueue[]>(static_cast<size_t>(numQueues_));
+
+    stop_.store(false, std::memory_order_relaxed);
+    generation_.store(0, std::memory_order_relaxed);
+    workers_.reserve(static_cast<size_t>(numWorkers));
+    for (int i = 0; i < numWorkers; ++i)
+        workers_.emplace_back([this, i] { workerLoop(i); });
+}
+
+void UpmixEngine::release() {
+    if (!workers_.empty()) {
+        stop_.store(true, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+        generation_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+        workers_.clear();
+    }
+
+    pipelines_.clear();
+    queues_.reset();
+    numQueues_ = 0;
+}
+
+void UpmixEngine::reset() {
+    for (auto& pipeline : pipelines_)
+        pipeline.reset();
+}
+
+void UpmixEngine::process(const StreamBlock* blocks, int numSamples) {
+    const int numStreams = getNumStreams();
+    if (numStreams == 0)
+        return;
+
+    jobBlocks_ = blocks;
+    jobNumSamples_ = numSamples;
+
+    // Contiguous share of the streams per queue; the caller owns the last one
+    for (int q = 0; q < numQueues_; ++q) {
+        queues_[static_cast<size_t>(q)].next.store(q * numStreams / numQueues_, std::memory_order_relaxed);
+        queues_[static_cast<size_t>(q)].end = (q + 1) * numStreams / numQueues_;
+    }
+
+    const int numWorkers = getNumWorkers();
+    workersDone_.store(0, std::memory_order_relaxed);
+    if (numWorkers > 0) {
+        generation_.fetch_add(1, std::memory_order_release);
+        generation_.notify_all();
+    }
+
+    runQueues(numQueues_ - 1);
+
+    // Every worker checks in once per generation, after its last stream.
+    // That also guarantees no worker still touches this job's data when the
+    // next process() call rewrites it.
+    for (int done = workersDone_.load(std::memory_order_acquire); done != numWorkers;
+         done = workersDone_.load(std::memory_order_acquire)) {
+        workersDone_.wait(done, std::memory_order_acquire);
+    }
+}
+
+void UpmixEngine::runQueues(int ownQueue) {
+    // Drain the own queue first, then steal from the others in turn
+    for (int k = 0; k < numQueues_; ++k) {
+        auto& queue = queues_[static_cast<size_t>((ownQueue + k) % numQueues_)];
+
+        for (int s = queue.next.fetch_add(1, std::memory_order_relaxed); s < queue.end;
+             s = queue.next.fetch_add(1, std::memory_order_relaxed)) {
+            const auto& block = jobBlocks_[s];
+            pipelines_[static_cast<size_t>(s)].process(
+                block.inputL, block.inputR, block.outputs, block.numOutputChannels,
+                jobNumSamples_, block.layout, block.dryWetTarget, block.gainDbTarget);
+        }
+    }
+}
+
+void UpmixEngine::workerLoop(int queueIndex) {
+    disableDenormals();
+    uint32_t seen = 0;
+
+    while (true) {
+        uint32_t current = generation_.load(std::memory_order_acquire);
+        for (int spin = 0; current == seen && spin < kWorkerSpinCount; ++spin)
+            current = generation_.load(std::memory_order_acquire);
+
+        if (current == seen) {
+            generation_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+        seen = current;
+
+        if (stop_.load(std::memory_order_relaxed))
+            return;
+
+        runQueues(queueIndex);
+
+        workersDone_.fetch_add(1, std::memory_order_acq_rel);
+        workersDone_.notify_one();
+    }
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,203 @@
+#include <UpmixRT/UpmixPipeline.h>
+#include <algorithm>
+#include <cmath>
+
+namespace audio_plugin {
+
+namespace {
+
+// True if every sample is exactly zero.
+bool isDigitalSilence(const float* data, int numSamples) {
+    float peak = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+        peak = std::max(peak, std::abs(data[i]));
+    return !(peak > 0.0f);
+}
+
+// output = input delayed by the length of history (numDelay samples), which
+// holds the last numDelay inputs and is updated.
+void delaySamples(const float* input, float* history, int numDelay, float* output, int numSamples) {
+    if (numSamples >= numDelay) {
+        std::copy(history, history + numDelay, output);
+        std::copy(input, input + numSamples - numDelay, output + numDelay);
+        std::copy(input + numSamples - numDelay, input + numSamples, history);
+    } else {
+        std::copy(history, history + numSamples, output);
+        std::copy(history + numSamples, history + numDelay, history);
+        std::copy(input, input + numSamples, history + numDelay - numSamples);
+    }
+}
+
+}  // namespace
+
+void UpmixPipeline::prepare(double sampleRate, int maxBlockSize, SpeakerLayout layout,
+                            const AnalysisConfig& config, VelvetBudget velvetBudget,
+                            SimdLevel maxSimdLevel) {
+    maxBlockSize_ = std::max(1, maxBlockSize);
+    kernels_ = &getSimdKernels(maxSimdLevel);
+
+    spatialAnalyzer_.prepare(sampleRate, config, *kernels_);
+    encoder_.prepare(sampleRate);
+    decoder_.prepare(sampleRate, layout, *kernels_);
+    outputWriter_.prepare(sampleRate, *kernels_);
+
+    int velvetTaps = kVelvetTapsPerChannel[static_cast<int>(velvetBudget)];
+    useVelvet_ = velvetTaps > 0;
+    velvet_.prepare(sampleRate, maxBlockSize_, useVelvet_ ? kMaxOutputChannels : 0, velvetTaps);
+
+    paramsScratch_.resize(static_cast<size_t>(maxBlockSize_));
+    bFormatScratch_.allocate(kNumAmbiChannels, maxBlockSize_);
+    wetGainScratch_.allocate(1, maxBlockSize_);
+    diffuseScratch_.allocate(useVelvet_ ? 1 : 0, maxBlockSize_);
+
+    latencySamples_ = spatialAnalyzer_.getLatencySamples();
+    delayHistory_.allocate(latencySamples_ > 0 ? kNumInputChannels : 0, latencySamples_);
+    delayedInput_.allocate(latencySamples_ > 0 ? kNumInputChannels : 0, maxBlockSize_);
+
+    // The diffuse decorrelation (the X/Z allpasses, or the velvet
+    // decorrelators that replace them when enabled) and the decoder are in
+    // series on the wet path, so their tails add up. That is conservative:
+    // the decoder's only state is the LFE lowpass, which filters W, and the
+    // encoder passes W through without memory. The analysis filters run in
+    // parallel and only shape the parameters, so the longer path wins. The
+    // latency delay comes before all of them.
+    int diffuseTail = useVelvet_ ? velvet_.getTailSamples() : encoder_.getTailSamples(kTailThreshold);
+    sampleRate_ = sampleRate;
+    tailSamples_ = latencySamples_
+                   + std::max(diffuseTail + decoder_.getTailSamples(kTailThreshold),
+                              spatialAnalyzer_.getTailSamples(kTailThreshold));
+    silentSamples_ = 0;
+    idle_ = false;
+}
+
+void UpmixPipeline::reset() {
+    spatialAnalyzer_.reset();
+    encoder_.reset();
+    decoder_.reset();
+    outputWriter_.reset();
+    velvet_.reset();
+    delayHistory_.clear();
+    silentSamples_ = 0;
+    idle_ = false;
+}
+
+void UpmixPipeline::setOutputRouting(const int* wetSpeakers, int numWetChannels) {
+    numWetChannels = std::clamp(numWetChannels, 0, kMaxOutputChannels);
+    bool routed[kMaxOutputChannels] = {};
+    wetSpeakers_.fill(-1);
+    for (int k = 0; k < numWetChannels; ++k) {
+        int spk = wetSpeakers[k];
+        if (spk < 0 || spk >= kMaxOutputChannels || routed[spk])
+            continue;
+        routed[spk] = true;
+        wetSpeakers_[static_cast<size_t>(k)] = spk;
+    }
+}
+
+double UpmixPipeline::getTailLengthSeconds() const {
+    if (maxBlockSize_ <= 0)
+        return 0.0;
+    return static_cast<double>(tailSamples_) / sampleRate_;
+}
+
+void UpmixPipeline::process(const float* inputL, const float* inputR,
+                            float* const* outputs, int numOutputChannels,
+                            int numSamples, SpeakerLayout layout,
+                            float dryWetTarget, float gainDbTarget) {
+    numOutputChannels = std::min(numOutputChannels, kMaxOutputChannels);
+    if (maxBlockSize_ <= 0) {
+        // Not prepared yet: the host must not get uninitialised buffers back
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+            std::fill_n(outputs[ch], numSamples, 0.0f);
+        return;
+    }
+
+    float* const* bFormat = bFormatScratch_.getArrayOfChannels();
+    float* wetGain = wetGainScratch_.getChannel(0);
+    SpatialParams* params = paramsScratch_.data();
+    int numWetChannels = std::max(0, numOutputChannels - 2);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize_) {
+        int n = std::min(maxBlockSize_, numSamples - start);
+        const float* L = inputL + start;
+        const float* R = inputR + start;
+
+        float* outputPtrs[kMaxOutputChannels];
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+            outputPtrs[ch] = outputs[ch] + start;
+
+        // 0. Silence skip. The chunk that completes the tail is still
+        // processed; after that the DSP state is cleared once, so the chain
+        // resumes from exact zeros (like a fresh prepare) without clicks.
+        if (isDigitalSilence(L, n) && isDigitalSilence(R, n)) {
+            if (silentSamples_ >= tailSamples_) {
+                if (!idle_) {
+                    spatialAnalyzer_.reset();
+                    encoder_.reset();
+                    decoder_.reset();
+                    velvet_.reset();
+                    delayHistory_.clear();
+                    idle_ = true;
+                }
+                for (int ch = 0; ch < numOutputChannels; ++ch)
+                    std::fill(outputPtrs[ch], outputPtrs[ch] + n, 0.0f);
+                continue;
+            }
+            silentSamples_ = std::min(silentSamples_ + n, tailSamples_);
+        } else {
+            silentSamples_ = 0;
+        }
+        idle_ = false;
+
+        // 1. Spatial analysis, then the audio delayed to line up with it
+        spatialAnalyzer_.processBlock(L, R, n, params);
+        if (latencySamples_ > 0) {
+            float* delayedL = delayedInput_.getChannel(0);
+            float* delayedR = delayedInput_.getChannel(1);
+            delaySamples(L, delayHistory_.getChannel(0), latencySamples_, delayedL, n);
+            delaySamples(R, delayHistory_.getChannel(1), latencySamples_, delayedR, n);
+            L = delayedL;
+            R = delayedR;
+        }
+
+        // 2. B-format encoding (phaseless W/Y + enriched X/Z), with the
+        // diffuse feed kept apart for the velvet decorrelators if enabled
+        float* diffuse = useVelvet_ ? diffuseScratch_.getChannel(0) : nullptr;
+        encoder_.encodeBlock(L, R, params, n, bFormat, diffuse);
+
+        // 3. Main out stays dry
+        outputWriter_.writeDry(L, R, n, numOutputChannels, outputPtrs);
+
+        // 4. Decode straight into the aux outputs that carry a speaker, with
+        // the dry/wet and gain multiplier fused in. At zero wet nothing is
+        // routed and the decoder only advances its state.
+        bool wet = outputWriter_.renderWetGain(n, dryWetTarget, gainDbTarget, wetGain);
+        float* speakers[kMaxOutputChannels] = {};
+        int numSpeakerOutputs = 0;
+        for (int k = 0; k < numWetChannels; ++k) {
+            int spk = wetSpeakers_[static_cast<size_t>(k)];
+            if (wet && spk >= 0) {
+                speakers[spk] = outputPtrs[2 + k];
+                numSpeakerOutputs = std::max(numSpeakerOutputs, spk + 1);
+            } else {
+                std::fill(outputPtrs[2 + k], outputPtrs[2 + k] + n, 0.0f);
+            }
+        }
+        if (!useVelvet_) {
+            decoder_.decodeBlock(bFormat, n, layout, speakers, numSpeakerOutputs, wetGain);
+            continue;
+        }
+
+        // 5. Per-speaker decorrelated diffuse, at each feed's X/Z weight as
+        // it moves through a layout crossfade
+        float weightsStart[kMaxOutputChannels];
+        float weightsEnd[kMaxOutputChannels];
+        decoder_.getDiffuseWeights(weightsStart, numSpeakerOutputs);
+        decoder_.decodeBlock(bFormat, n, layout, speakers, numSpeakerOutputs, wetGain);
+        decoder_.getDiffuseWeights(weightsEnd, numSpeakerOutputs);
+        velvet_.processBlock(diffuse, n, speakers, numSpeakerOutputs,
+                             weightsStart, weightsEnd, wetGain);
+    }
+}
+
+}  // namespace audio_plugin
@@ -0,0 +1,119 @@
+#include <UpmixRT/VelvetDecorrelator.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace audio_plugin {
+
+void VelvetDecorrelatorBank::prepare(double sampleRate, int maxBlockSize, int numChannels,
+                                     int tapsPerChannel) {
+    maxBlockSize_ = std::max(1, maxBlockSize);
+    numChannels_ = std::max(0, numChannels);
+    historyLength_ = std::max(1, static_cast<int>(std::round(sampleRate * static_cast<double>(kVelvetLengthSec))));
+    tapsPerChannel_ = std::clamp(tapsPerChannel, 0, historyLength_);
+
+    // One tap per grid cell. A fixed LCG per channel keeps the taps the same
+    // on every platform and run.
+    taps_.assign(static_cast<size_t>(numChannels_ * tapsPerChannel_), Tap{});
+    float cell = static_cast<float>(historyLength_) / static_cast<float>(std::max(1, tapsPerChannel_));
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        uint32_t seed = 0x9E3779B9u * static_cast<uint32_t>(ch + 1);
+        auto nextRandom = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 16777216.0f;  // [0, 1)
+        };
+
+        Tap* taps = taps_.data() + ch * tapsPerChannel_;
+        float energy = 0.0f;
+        for (int k = 0; k < tapsPerChannel_; ++k) {
+            float position = (static_cast<float>(k) + nextRandom()) * cell;
+            int delay = std::min(static_cast<int>(position), historyLength_ - 1);
+            float sign = nextRandom() < 0.5f ? -1.0f : 1.0f;
+            float envelope = std::pow(10.0f, kVelvetDecayDb / 20.0f * static_cast<float>(delay)
+                                                 / static_cast<float>(historyLength_));
+            taps[k] = { delay, sign * envelope };
+            energy += envelope * envelope;
+        }
+
+        float norm = 1.0f / std::sqrt(std::max(energy, kEpsilon));
+        for (int k = 0; k < tapsPerChannel_; ++k)
+            taps[k].weight *= norm;
+    }
+
+    ringSize_ = historyLength_ + maxBlockSize_;
+    history_.assign(static_cast<size_t>(2 * ringSize_), 0.0f);
+    writeIndex_ = 0;
+    accumulator_.allocate(1, maxBlockSize_);
+}
+
+void VelvetDecorrelatorBank::reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    writeIndex_ = 0;
+}
+
+void VelvetDecorrelatorBank::processBlock(const float* input, int numSamples,
+                                          float* const* outputs, int numOutputs,
+                                          const float* weightsStart, const float* weightsEnd,
+                                          const float* gain) {
+    numOutputs = std::min(numOutputs, numChannels_);
+    float* acc = accumulator_.getChannel(0);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize_) {
+        int n = std::min(maxBlockSize_, numSamples - start);
+        // Write the chunk into both halves of the mirrored ring, so the
+        // historyLength_ + n samples the taps read are contiguous in one of
+        // them: each chunk costs 2n writes instead of a history shift
+        int first = std::min(n, ringSize_ - writeIndex_);
+        float* ring = history_.data();
+        std::copy(input + start, input + start + first, ring + writeIndex_);
+        std::copy(input + start, input + start + first, ring + ringSize_ + writeIndex_);
+        std::copy(input + start + first, input + start + n, ring);
+        std::copy(input + start + first, input + start + n, ring + ringSize_);
+        float* now = ring + (writeIndex_ >= historyLength_ ? writeIndex_ : writeIndex_ + ringSize_);
+
+        for (int ch = 0; ch < numOutputs; ++ch) {
+            float weightStart = weightsStart[ch];
+            float weightEnd = weightsEnd[ch];
+            if (outputs[ch] == nullptr || std::max(std::abs(weightStart), std::abs(weightEnd)) <= 0.0f)
+                continue;
+
+            // Sparse FIR: each tap adds the whole block, delayed, at once,
+            // four taps per pass over the accumulator
+            std::fill(acc, acc + n, 0.0f);
+            const Tap* taps = taps_.data() + ch * tapsPerChannel_;
+            int k = 0;
+            for (; k + 4 <= tapsPerChannel_; k += 4) {
+                const float* d0 = now - taps[k].delay;
+                const float* d1 = now - taps[k + 1].delay;
+                const float* d2 = now - taps[k + 2].delay;
+                const float* d3 = now - taps[k + 3].delay;
+                float w0 = taps[k].weight, w1 = taps[k + 1].weight;
+                float w2 = taps[k + 2].weight, w3 = taps[k + 3].weight;
+                for (int s = 0; s < n; ++s)
+                    acc[s] += (w0 * d0[s] + w1 * d1[s]) + (w2 * d2[s] + w3 * d3[s]);
+            }
+            for (; k < tapsPerChannel_; ++k) {
+                const float* delayed = now - taps[k].delay;
+                float weight = taps[k].weight;
+                for (int s = 0; s < n; ++s)
+                    acc[s] += weight * delayed[s];
+            }
+
+            // Weight ramp over the whole block (not each chunk of it)
+            float* out = outputs[ch] + start;
+            float step = (weightEnd - weightStart) / static_cast<float>(numSamples);
+            float base = weightStart + step * static_cast<float>(start + 1);
+            if (gain != nullptr) {
+                for (int s = 0; s < n; ++s)
+                    out[s] += acc[s] * (base + step * static_cast<float>(s)) * gain[start + s];
+            } else {
+                for (int s = 0; s < n; ++s)
+                    out[s] += acc[s] * (base + step * static_cast<float>(s));
+            }
+        }
+
+        writeIndex_ = (writeIndex_ + n) % ringSize_;
+    }
+}
+
+}  // namespace audio_plugin
@@ -5,15 +5,20 @@
 
 namespace audio_plugin {
 
-class AudioPluginAudioProcessorEditor : public juce::AudioProcessorEditor {
+class AudioPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                        private juce::Timer {
 public:
     explicit AudioPluginAudioProcessorEditor(AudioPluginAudioProcessor&);
     ~AudioPluginAudioProcessorEditor() override;
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void mouseDown(const juce::MouseEvent& event) override;
 
 private:
+    void timerCallback() override;
+    void paintLoadMeter(juce::Graphics& g);
+
     AudioPluginAudioProcessor& processorRef_;
 
     juce::ComboBox layoutSelector_;
@@ -27,6 +32,10 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> dryWetAttachment_;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment_;
 
+    // CPU load meter, polled from the processor's LoadMeter; click to reset
+    LoadMeter::Snapshot loadSnapshot_;
+    juce::Rectangle<int> loadMeterArea_;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessorEditor)
 };
 
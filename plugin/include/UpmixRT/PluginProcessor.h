@@ -2,10 +2,8 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Constants.h"
-#include "SpatialAnalyzer.h"
-#include "AmbisonicEncoder.h"
-#include "AmbisonicDecoder.h"
-#include "OutputWriter.h"
+#include "LoadMeter.h"
+#include "UpmixPipeline.h"
 
 namespace audio_plugin {
 
@@ -17,6 +15,7 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    void processorLayoutsChanged() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
@@ -39,21 +38,39 @@ public:
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts_; }
 
+    // Analyzer options (e.g. control-rate mode); applied on the next prepareToPlay.
+    void setAnalysisConfig(const AnalysisConfig& config) { analysisConfig_ = config; }
+    const AnalysisConfig& getAnalysisConfig() const { return analysisConfig_; }
+
+    // Per-speaker diffuse decorrelation budget; applied on the next prepareToPlay.
+    void setVelvetBudget(VelvetBudget budget) { velvetBudget_ = budget; }
+    VelvetBudget getVelvetBudget() const { return velvetBudget_; }
+
+    // Real-time load of processBlock(); safe to poll from the message thread.
+    LoadMeter& getLoadMeter() { return loadMeter_; }
+
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    // The discrete wet bus layout if there is one, the Layout parameter otherwise
+    SpeakerLayout getActiveLayout() const;
     static BusesProperties createBusesProperties();
 
     juce::AudioProcessorValueTreeState apvts_;
 
-    SpatialAnalyzer spatialAnalyzer_;
-    AmbisonicEncoder encoder_;
-    AmbisonicDecoder decoder_;
-    OutputWriter outputWriter_;
+    AnalysisConfig analysisConfig_;
+    VelvetBudget velvetBudget_ = VelvetBudget::Off;
+    UpmixPipeline pipeline_;
+    LoadMeter loadMeter_;
 
     std::atomic<float>* layoutParam_ = nullptr;
     std::atomic<float>* dryWetParam_ = nullptr;
     std::atomic<float>* gainParam_ = nullptr;
 
+    // SpeakerLayout of a discrete wet bus, -1 while the wet feeds go to
+    // stereo aux buses. Set in processorLayoutsChanged() on the message
+    // thread, read by processBlock() on the audio thread.
+    std::atomic<int> wetBusLayout_{-1};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
 
@@ -1,11 +1,13 @@
 #include <UpmixRT/PluginEditor.h>
+#include <algorithm>
+#include <cmath>
 
 namespace audio_plugin {
 
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
     AudioPluginAudioProcessor& p)
     : AudioProcessorEditor(&p), processorRef_(p) {
-    setSize(300, 240);
+    setSize(300, 340);
 
     // Layout selector
     layoutLabel_.setText("Layout", juce::dontSendNotification);
@@ -40,6 +42,8 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
     gainAttachment_ = std::make_unique<
         juce::AudioProcessorValueTreeState::SliderAttachment>(
         processorRef_.getAPVTS(), ParamID::kGain, gainSlider_);
+
+    startTimerHz(10);
 }
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() = default;
@@ -50,6 +54,59 @@ void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g) {
     g.setFont(18.0f);
     g.drawText("UpmixRT", getLocalBounds().removeFromTop(40),
                juce::Justification::centred);
+
+    paintLoadMeter(g);
+}
+
+void AudioPluginAudioProcessorEditor::paintLoadMeter(juce::Graphics& g) {
+    constexpr int kNumBins = LoadMeter::kNumLoadBins;
+    const auto& snapshot = loadSnapshot_;
+    auto area = loadMeterArea_;
+
+    g.setColour(juce::Colours::white);
+    g.setFont(13.0f);
+    g.drawText(juce::String::formatted("CPU %.1f%%   peak %.1f%%   missed %u",
+                                       100.0f * snapshot.currentLoad,
+                                       100.0f * snapshot.peakLoad,
+                                       snapshot.histogram[kNumBins - 1]),
+               area.removeFromTop(20), juce::Justification::centredLeft);
+
+    // Histogram of block loads: 10% bins, the last bin is missed deadlines
+    auto labels = area.removeFromBottom(14);
+    g.setFont(11.0f);
+    g.drawText("0%", labels, juce::Justification::centredLeft);
+    g.drawText(">100%", labels, juce::Justification::centredRight);
+
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.fillRect(area);
+
+    uint32_t maxCount = 1;
+    for (auto count : snapshot.histogram)
+        maxCount = std::max(maxCount, count);
+
+    const float binWidth = static_cast<float>(area.getWidth()) / static_cast<float>(kNumBins);
+    for (int bin = 0; bin < kNumBins; ++bin) {
+        auto count = snapshot.histogram[static_cast<size_t>(bin)];
+        if (count == 0)
+            continue;
+        // Square-root scale keeps rare long blocks visible next to the mode
+        float height = static_cast<float>(area.getHeight())
+                       * std::sqrt(static_cast<float>(count) / static_cast<float>(maxCount));
+        g.setColour(bin == kNumBins - 1 ? juce::Colours::red : juce::Colours::lightgreen);
+        g.fillRect(static_cast<float>(area.getX()) + binWidth * static_cast<float>(bin) + 1.0f,
+                   static_cast<float>(area.getBottom()) - height,
+                   binWidth - 2.0f, height);
+    }
+}
+
+void AudioPluginAudioProcessorEditor::timerCallback() {
+    loadSnapshot_ = processorRef_.getLoadMeter().getSnapshot();
+    repaint(loadMeterArea_);
+}
+
+void AudioPluginAudioProcessorEditor::mouseDown(const juce::MouseEvent& event) {
+    if (loadMeterArea_.contains(event.getPosition()))
+        processorRef_.getLoadMeter().requestReset();
 }
 
 void AudioPluginAudioProcessorEditor::resized() {
@@ -71,6 +128,9 @@ void AudioPluginAudioProcessorEditor::resized() {
     auto row3 = area.removeFromTop(30);
     gainLabel_.setBounds(row3.removeFromLeft(60));
     gainSlider_.setBounds(row3);
+
+    area.removeFromTop(15);
+    loadMeterArea_ = area;
 }
 
 }  // namespace audio_plugin
@@ -3,6 +3,59 @@
 
 namespace audio_plugin {
 
+namespace {
+
+// Channel type of each speaker feed of `layout`, in decoder order
+juce::Array<juce::AudioChannelSet::ChannelType> getSpeakerChannelTypes(SpeakerLayout layout) {
+    using Set = juce::AudioChannelSet;
+    switch (layout) {
+        case SpeakerLayout::Stereo:
+            return { Set::left, Set::right };
+        case SpeakerLayout::Surround51:
+            return { Set::left, Set::right, Set::centre, Set::LFE,
+                     Set::leftSurround, Set::rightSurround };
+        case SpeakerLayout::Surround714:
+            return { Set::left, Set::right, Set::centre, Set::LFE,
+                     Set::leftSurroundSide, Set::rightSurroundSide,
+                     Set::leftSurroundRear, Set::rightSurroundRear,
+                     Set::topFrontLeft, Set::topFrontRight, Set::topRearLeft, Set::topRearRight };
+        case SpeakerLayout::Surround916:
+            return { Set::left, Set::right, Set::centre, Set::LFE,
+                     Set::leftSurroundSide, Set::rightSurroundSide,
+                     Set::leftSurroundRear, Set::rightSurroundRear,
+                     Set::topFrontLeft, Set::topFrontRight, Set::topRearLeft, Set::topRearRight,
+                     Set::topSideLeft, Set::topSideRight, Set::wideLeft, Set::wideRight };
+        case SpeakerLayout::Surround222:
+            return { Set::left, Set::right, Set::centre, Set::LFE,
+                     Set::leftSurroundRear, Set::rightSurroundRear,
+                     Set::leftCentre, Set::rightCentre, Set::centreSurround, Set::LFE2,
+                     Set::leftSurroundSide, Set::rightSurroundSide,
+                     Set::topFrontLeft, Set::topFrontRight, Set::topFrontCentre, Set::topMiddle,
+                     Set::topRearLeft, Set::topRearRight, Set::topSideLeft, Set::topSideRight,
+                     Set::topRearCentre, Set::bottomFrontCentre, Set::bottomFrontLeft,
+                     Set::bottomFrontRight };
+        case SpeakerLayout::AmbiX:
+            return { Set::ambisonicACN0, Set::ambisonicACN1, Set::ambisonicACN2, Set::ambisonicACN3 };
+        case SpeakerLayout::kNumLayouts:
+            break;
+    }
+    return {};
+}
+
+// Layout carried by a discrete multichannel wet bus with this channel set,
+// or -1. Stereo is left to the stereo aux buses.
+int findDiscreteWetLayout(const juce::AudioChannelSet& set) {
+    for (int i = 0; i < static_cast<int>(SpeakerLayout::kNumLayouts); ++i) {
+        auto layout = static_cast<SpeakerLayout>(i);
+        if (layout != SpeakerLayout::Stereo
+            && set == juce::AudioChannelSet::channelSetWithChannels(getSpeakerChannelTypes(layout)))
+            return i;
+    }
+    return -1;
+}
+
+}  // namespace
+
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     : AudioProcessor(createBusesProperties()),
       apvts_(*this, nullptr, "Parameters", createParameterLayout()) {
@@ -17,6 +70,8 @@ juce::AudioProcessor::BusesProperties AudioPluginAudioProcessor::createBusesProp
     // Multi-out: 1 main stereo bus (dry) + 12 aux stereo buses (wet) = 26 channels.
     // This allows full 22.2 wet routing (24 ch) while keeping main 1-2 dry.
     // DAWs like Ableton expose each bus as a routable output pair.
+    // Alternatively the first aux bus can carry the whole upmix as one
+    // discrete bus in the layout's channel set (see isBusesLayoutSupported).
     constexpr int kNumAuxBuses = 12;
     const juce::String auxNames[] = {
         "1/2",  "3/4",  "5/6",  "7/8",
@@ -62,20 +117,25 @@ AudioPluginAudioProcessor::createParameterLayout() {
     return layout;
 }
 
-void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/) {
-    auto layout = static_cast<SpeakerLayout>(static_cast<int>(layoutParam_->load()));
+SpeakerLayout AudioPluginAudioProcessor::getActiveLayout() const {
+    const int busLayout = wetBusLayout_.load();
+    if (busLayout >= 0)
+        return static_cast<SpeakerLayout>(busLayout);
+    return static_cast<SpeakerLayout>(static_cast<int>(layoutParam_->load()));
+}
+
+void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    auto layout = getActiveLayout();
 
-    spatialAnalyzer_.prepare(sampleRate);
-    encoder_.prepare(sampleRate);
-    decoder_.prepare(sampleRate, layout);
-    outputWriter_.prepare(sampleRate);
+    // Hosts may still deliver larger blocks; the pipeline splits those.
+    // It also picks the widest kernel instruction set the CPU supports.
+    pipeline_.prepare(sampleRate, samplesPerBlock, layout, analysisConfig_, velvetBudget_);
+    setLatencySamples(pipeline_.getLatencySamples());  // STFT analysis only
+    loadMeter_.prepare(sampleRate);
 }
 
 void AudioPluginAudioProcessor::releaseResources() {
-    spatialAnalyzer_.reset();
-    encoder_.reset();
-    decoder_.reset();
-    outputWriter_.reset();
+    pipeline_.reset();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
@@ -87,6 +147,16 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
     if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
         return false;
 
+    // Discrete wet bus: the first aux bus in a layout's channel set, all
+    // other aux buses disabled
+    if (layouts.outputBuses.size() > 1 && findDiscreteWetLayout(layouts.outputBuses[1]) >= 0) {
+        for (int i = 2; i < layouts.outputBuses.size(); ++i) {
+            if (!layouts.outputBuses[i].isDisabled())
+                return false;
+        }
+        return true;
+    }
+
     // Each aux output bus must be either stereo or disabled
     for (int i = 1; i < layouts.outputBuses.size(); ++i) {
         const auto& bus = layouts.outputBuses[i];
@@ -97,53 +167,72 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
     return true;
 }
 
+void AudioPluginAudioProcessor::processorLayoutsChanged() {
+    int wetSpeakers[kMaxOutputChannels];
+    int numWetChannels = 0;
+
+    // Discrete wet bus: it selects the layout, and each of its channels
+    // carries the speaker of the same channel type (hosts order them their
+    // own way)
+    const auto* wetBus = getBus(false, 1);
+    const int busLayout = (wetBus != nullptr && wetBus->isEnabled())
+                              ? findDiscreteWetLayout(wetBus->getCurrentLayout()) : -1;
+    wetBusLayout_.store(busLayout);
+    if (busLayout >= 0) {
+        const auto types = getSpeakerChannelTypes(static_cast<SpeakerLayout>(busLayout));
+        const auto& channelSet = wetBus->getCurrentLayout();
+        for (int ch = 0; ch < channelSet.size() && numWetChannels < kMaxOutputChannels; ++ch)
+            wetSpeakers[numWetChannels++] = types.indexOf(channelSet.getTypeOfChannel(ch));
+        pipeline_.setOutputRouting(wetSpeakers, numWetChannels);
+        return;
+    }
+
+    // Disabled aux buses have no buffer channels, so map each buffer channel
+    // past main 1-2 to the speaker feed of its bus: aux bus i carries
+    // speakers 2i and 2i+1. Only those feeds get decoded.
+    for (int busIndex = 1; busIndex < getBusCount(false); ++busIndex) {
+        const auto* bus = getBus(false, busIndex);
+        if (bus == nullptr || !bus->isEnabled())
+            continue;
+
+        int firstSpeaker = 2 * (busIndex - 1);
+        for (int ch = 0; ch < bus->getNumberOfChannels() && numWetChannels < kMaxOutputChannels; ++ch)
+            wetSpeakers[numWetChannels++] = firstSpeaker + ch;
+    }
+    pipeline_.setOutputRouting(wetSpeakers, numWetChannels);
+}
+
 void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& /*midiMessages*/) {
     juce::ScopedNoDenormals noDenormals;
+    LoadMeter::ScopedMeasurement loadMeasurement(loadMeter_, buffer.getNumSamples());
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    // Clear any output channels beyond input
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
-
-    auto layout = static_cast<SpeakerLayout>(static_cast<int>(layoutParam_->load()));
+    auto layout = getActiveLayout();
     float dryWetTarget = dryWetParam_->load();
     float gainDbTarget = gainParam_->load();
 
     int numSamples = buffer.getNumSamples();
     int numOutputChannels = std::min(totalNumOutputChannels, kMaxOutputChannels);
 
+    // The pipeline writes every channel it is given (dry, decoded or
+    // silent), so only channels past kMaxOutputChannels need clearing
+    for (auto i = numOutputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear(i, 0, numSamples);
+
     // Get output write pointers
     float* outputPtrs[kMaxOutputChannels];
     for (int ch = 0; ch < numOutputChannels; ++ch)
         outputPtrs[ch] = buffer.getWritePointer(ch);
 
-    float speakerOutputs[kMaxOutputChannels];
-    float bFormat[kNumAmbiChannels];
-
     // Read input (always stereo)
     const float* inL = buffer.getReadPointer(0);
     const float* inR = (totalNumInputChannels > 1) ? buffer.getReadPointer(1) : inL;
 
-    for (int s = 0; s < numSamples; ++s) {
-        float L = inL[s];
-        float R = inR[s];
-
-        // 1. Spatial analysis
-        SpatialParams params = spatialAnalyzer_.process(L, R);
-
-        // 2. B-format encoding (phaseless W/Y + enriched X/Z)
-        encoder_.encode(L, R, params, bFormat);
-
-        // 3. Decode to speaker feeds
-        decoder_.decode(bFormat, layout, speakerOutputs);
-
-        // 4. Main out stays dry; upmix wet signal is routed to aux outputs
-        outputWriter_.writeSample(speakerOutputs, L, R, dryWetTarget,
-                                  gainDbTarget, numOutputChannels, outputPtrs, s);
-    }
+    pipeline_.process(inL, inR, outputPtrs, numOutputChannels, numSamples,
+                      layout, dryWetTarget, gainDbTarget);
 }
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor() {
@@ -155,7 +244,7 @@ const juce::String AudioPluginAudioProcessor::getName() const { return "UpmixRT"
 bool AudioPluginAudioProcessor::acceptsMidi() const { return false; }
 bool AudioPluginAudioProcessor::producesMidi() const { return false; }
 bool AudioPluginAudioProcessor::isMidiEffect() const { return false; }
-double AudioPluginAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double AudioPluginAudioProcessor::getTailLengthSeconds() const { return pipeline_.getTailLengthSeconds(); }
 
 int AudioPluginAudioProcessor::getNumPrograms() { return 1; }
 int AudioPluginAudioProcessor::getCurrentProgram() { return 0; }
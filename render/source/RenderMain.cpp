@@ -0,0 +1,272 @@
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <UpmixRT/SpeakerLayout.h>
+#include <UpmixRT/UpmixPipeline.h>
+#include <iostream>
+
+// upmixrt-render: offline stereo-to-multichannel upmix of WAV/AIFF files.
+// Runs the same UpmixPipeline as the plugin, without the editor, on large
+// blocks and reports the real-time factor of the render.
+
+namespace {
+
+using namespace audio_plugin;
+
+struct RenderOptions {
+    juce::File input;
+    juce::File output;
+    SpeakerLayout layout = SpeakerLayout::Surround51;
+    int blockSize = 4096;
+    int bitDepth = 24;
+    float dryWet = 1.0f;
+    float gainDb = 0.0f;
+    bool includeDry = false;
+    AnalysisConfig analysis;
+    VelvetBudget velvet = VelvetBudget::Off;
+    SimdLevel maxSimdLevel = SimdLevel::AVX512;
+};
+
+void printUsage() {
+    std::cout
+        << "Usage: upmixrt-render <input.wav|aiff> <output.wav|aiff> [options]\n"
+           "\n"
+           "Options:\n"
+           "  --layout <name>         stereo | 5.1 | 7.1.4 | 9.1.6 | 22.2 | ambix (default 5.1)\n"
+           "  --block <samples>       processing block size (default 4096)\n"
+           "  --bits <16|24|32>       output bit depth (default 24)\n"
+           "  --dry-wet <0..1>        wet level of the upmix channels (default 1)\n"
+           "  --gain <dB>             wet output gain, -42..0 (default 0)\n"
+           "  --control-rate <N>      derive spatial parameters every N samples (default 1)\n"
+           "  --filter-bank <type>    cascade | parallel | time-parallel analysis bands (default cascade)\n"
+           "  --multirate             analyse the low bands (and, above 48 kHz, all bands)\n"
+           "                          on a decimated signal\n"
+           "  --stft <bands>          analyse on a short-time FFT grouped into <bands>\n"
+           "                          perceptual bands (1..64) instead of the filter bank\n"
+           "  --band-scale <scale>    bark | erb spacing of the STFT bands (default bark)\n"
+           "  --velvet <budget>       off | low | medium | high per-speaker diffuse\n"
+           "                          decorrelation (default off)\n"
+           "  --simd <level>          scalar | sse2 | neon | avx2 | avx512: widest kernel\n"
+           "                          instruction set to use, if the CPU has it (default avx512)\n"
+           "  --include-dry           prepend the dry stereo input as channels 1-2\n";
+}
+
+bool parseLayout(const juce::String& name, SpeakerLayout& layout) {
+    for (int i = 0; i < static_cast<int>(SpeakerLayout::kNumLayouts); ++i) {
+        auto candidate = static_cast<SpeakerLayout>(i);
+        if (name.equalsIgnoreCase(getLayoutInfo(candidate).name)) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseArguments(const juce::StringArray& args, RenderOptions& options) {
+    juce::StringArray positional;
+
+    for (int i = 0; i < args.size(); ++i) {
+        const auto& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--include-dry") {
+            options.includeDry = true;
+        } else if (arg == "--multirate") {
+            options.analysis.multirate = true;
+        } else if (arg.startsWith("--")) {
+            if (!hasValue) {
+                std::cerr << "Missing value for " << arg << "\n";
+                return false;
+            }
+            const auto value = args[++i];
+
+            if (arg == "--layout") {
+                if (!parseLayout(value, options.layout)) {
+                    std::cerr << "Unknown layout: " << value << "\n";
+                    return false;
+                }
+            } else if (arg == "--block") {
+                options.blockSize = juce::jlimit(16, 1 << 20, value.getIntValue());
+            } else if (arg == "--bits") {
+                const int bits = value.getIntValue();
+                if (bits != 16 && bits != 24 && bits != 32) {
+                    std::cerr << "Unsupported bit depth: " << value << "\n";
+                    return false;
+                }
+                options.bitDepth = bits;
+            } else if (arg == "--dry-wet") {
+                options.dryWet = juce::jlimit(0.0f, 1.0f, value.getFloatValue());
+            } else if (arg == "--gain") {
+                options.gainDb = juce::jlimit(-42.0f, 0.0f, value.getFloatValue());
+            } else if (arg == "--control-rate") {
+                options.analysis.controlInterval = juce::jmax(1, value.getIntValue());
+            } else if (arg == "--filter-bank") {
+                if (value == "cascade") {
+                    options.analysis.filterBankTopology = FilterBankTopology::Cascade;
+                } else if (value == "parallel") {
+                    options.analysis.filterBankTopology = FilterBankTopology::Parallel;
+                } else if (value == "time-parallel") {
+                    options.analysis.filterBankTopology = FilterBankTopology::CascadeTimeParallel;
+                } else {
+                    std::cerr << "Unknown filter bank: " << value << "\n";
+                    return false;
+                }
+            } else if (arg == "--stft") {
+                options.analysis.engine = AnalysisEngine::Stft;
+                options.analysis.stftNumBands = juce::jlimit(1, kStftMaxBands, value.getIntValue());
+            } else if (arg == "--band-scale") {
+                if (value == "bark") {
+                    options.analysis.stftBandScale = BandScale::Bark;
+                } else if (value == "erb") {
+                    options.analysis.stftBandScale = BandScale::Erb;
+                } else {
+                    std::cerr << "Unknown band scale: " << value << "\n";
+                    return false;
+                }
+            } else if (arg == "--velvet") {
+                const juce::StringArray budgets { "off", "low", "medium", "high" };
+                int index = budgets.indexOf(value, true);
+                if (index < 0) {
+                    std::cerr << "Unknown velvet budget: " << value << "\n";
+                    return false;
+                }
+                options.velvet = static_cast<VelvetBudget>(index);
+            } else if (arg == "--simd") {
+                const juce::StringArray levels { "scalar", "sse2", "neon", "avx2", "avx512" };
+                int index = levels.indexOf(value, true);
+                if (index < 0) {
+                    std::cerr << "Unknown SIMD level: " << value << "\n";
+                    return false;
+                }
+                options.maxSimdLevel = static_cast<SimdLevel>(index);
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                return false;
+            }
+        } else {
+            positional.add(arg);
+        }
+    }
+
+    if (positional.size() != 2)
+        return false;
+
+    options.input = juce::File::getCurrentWorkingDirectory().getChildFile(positional[0]);
+    options.output = juce::File::getCurrentWorkingDirectory().getChildFile(positional[1]);
+    return true;
+}
+
+int render(const RenderOptions& options) {
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(options.input));
+    if (reader == nullptr) {
+        std::cerr << "Cannot read " << options.input.getFullPathName() << "\n";
+        return 1;
+    }
+
+    auto* outputFormat = formatManager.findFormatForFileExtension(options.output.getFileExtension());
+    if (outputFormat == nullptr) {
+        std::cerr << "Unsupported output format: " << options.output.getFileName() << "\n";
+        return 1;
+    }
+
+    const auto& layoutInfo = getLayoutInfo(options.layout);
+    const double sampleRate = reader->sampleRate;
+    const auto totalSamples = reader->lengthInSamples;
+    const int blockSize = options.blockSize;
+
+    // Pipeline output: dry stereo on 0-1, wet layout channels from 2
+    const int numPipelineChannels = 2 + layoutInfo.numChannels;
+    const int firstFileChannel = options.includeDry ? 0 : 2;
+    const int numFileChannels = numPipelineChannels - firstFileChannel;
+
+    options.output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(options.output.createOutputStream());
+    if (stream == nullptr) {
+        std::cerr << "Cannot write " << options.output.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(outputFormat->createWriterFor(
+        stream.get(), sampleRate, static_cast<unsigned int>(numFileChannels),
+        options.bitDepth, {}, 0));
+    if (writer == nullptr) {
+        std::cerr << "Cannot create a " << numFileChannels << "-channel "
+                  << options.bitDepth << "-bit writer for " << options.output.getFileName() << "\n";
+        return 1;
+    }
+    stream.release();  // now owned by the writer
+
+    UpmixPipeline pipeline;
+    pipeline.prepare(sampleRate, blockSize, options.layout, options.analysis, options.velvet,
+                     options.maxSimdLevel);
+
+    juce::AudioBuffer<float> input(kNumInputChannels, blockSize);
+    juce::AudioBuffer<float> output(numPipelineChannels, blockSize);
+
+    double dspMs = 0.0;
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    // The pipeline's latency is compensated: its first latency output
+    // samples are dropped and as many zeros are fed after the input
+    const int latency = pipeline.getLatencySamples();
+    const juce::int64 totalProcessed = totalSamples + latency;
+    juce::int64 toSkip = latency;
+
+    for (juce::int64 pos = 0; pos < totalProcessed; pos += blockSize) {
+        const int n = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalProcessed - pos));
+
+        // Mono files are duplicated to both channels by the reader, which
+        // also zero-fills past the end of the file
+        reader->read(&input, 0, n, pos, true, true);
+
+        const double blockStartMs = juce::Time::getMillisecondCounterHiRes();
+        pipeline.process(input.getReadPointer(0), input.getReadPointer(1),
+                         output.getArrayOfWritePointers(), numPipelineChannels, n,
+                         options.layout, options.dryWet, options.gainDb);
+        dspMs += juce::Time::getMillisecondCounterHiRes() - blockStartMs;
+
+        const int skip = static_cast<int>(juce::jmin(toSkip, static_cast<juce::int64>(n)));
+        toSkip -= skip;
+        if (skip == n)
+            continue;
+
+        const float* fileChannels[kMaxOutputChannels];
+        for (int ch = 0; ch < numFileChannels; ++ch)
+            fileChannels[ch] = output.getReadPointer(firstFileChannel + ch) + skip;
+        if (!writer->writeFromFloatArrays(fileChannels, numFileChannels, n - skip)) {
+            std::cerr << "Write failed at sample " << pos << "\n";
+            return 1;
+        }
+    }
+
+    writer.reset();  // flush the file header before reporting
+    const double totalMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+    const double audioMs = 1000.0 * static_cast<double>(totalSamples) / sampleRate;
+
+    std::cout << options.input.getFileName() << " -> " << options.output.getFileName()
+              << " (" << layoutInfo.name << ", " << numFileChannels << " ch, "
+              << sampleRate << " Hz, " << getSimdLevelName(pipeline.getSimdLevel()) << " kernels)\n"
+              << juce::String::formatted(
+                     "audio %.2f s | total %.3f s (%.1fx real time) | DSP %.3f s (%.1fx real time)\n",
+                     audioMs / 1000.0,
+                     totalMs / 1000.0, audioMs / juce::jmax(totalMs, 1.0e-3),
+                     dspMs / 1000.0, audioMs / juce::jmax(dspMs, 1.0e-3));
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    RenderOptions options;
+    if (!parseArguments(args, options)) {
+        printUsage();
+        return 2;
+    }
+
+    return render(options);
+}
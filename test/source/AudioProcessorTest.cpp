@@ -1,17 +1,34 @@
 #include <gtest/gtest.h>
-#include <UpmixRT/PluginProcessor.h>
 #include <UpmixRT/Constants.h>
 #include <UpmixRT/SpeakerLayout.h>
 #include <UpmixRT/AmbisonicEncoder.h>
 #include <UpmixRT/AmbisonicDecoder.h>
 #include <UpmixRT/SpatialAnalyzer.h>
+#include <UpmixRT/BiquadBank.h>
 #include <UpmixRT/Decorrelator.h>
+#include <UpmixRT/VelvetDecorrelator.h>
 #include <UpmixRT/FilterBank.h>
+#include <UpmixRT/HalfBandDecimator.h>
+#include <UpmixRT/Biquad.h>
 #include <UpmixRT/AnalysisBand.h>
+#include <UpmixRT/AnalysisBank.h>
+#include <UpmixRT/StereoFft.h>
+#include <UpmixRT/StftAnalyzer.h>
 #include <UpmixRT/HeightEstimator.h>
 #include <UpmixRT/OutputWriter.h>
+#include <UpmixRT/UpmixPipeline.h>
+#include <UpmixRT/UpmixEngine.h>
+#include <UpmixRT/LoadMeter.h>
+#include <UpmixRT/FastMath.h>
+#include <UpmixRT/SimdKernels.h>
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <array>
+#include <vector>
 
 using namespace audio_plugin;
 
@@ -432,6 +449,72 @@ TEST(DecorrelatorTest, ResetClearsState) {
     }
 }
 
+TEST(DecorrelatorTest, AllpassPreservesMagnitudeMaxStages) {
+    Decorrelator decorr;
+    decorr.prepare(44100.0, kDecorrDelaysZ, kMaxDecorrStages);
+
+    constexpr int numSamples = 20000;
+    std::vector<float> input(numSamples), output(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        input[static_cast<size_t>(i)] = std::sin(2.0f * kPi * 1000.0f * static_cast<float>(i) / 44100.0f);
+    decorr.processBlock(input.data(), output.data(), numSamples);
+
+    float inputMag = 0.0f;
+    float outputMag = 0.0f;
+    for (int i = 10000; i < numSamples; ++i) {
+        inputMag += input[static_cast<size_t>(i)] * input[static_cast<size_t>(i)];
+        outputMag += output[static_cast<size_t>(i)] * output[static_cast<size_t>(i)];
+    }
+
+    float ratio = outputMag / (inputMag + kEpsilon);
+    EXPECT_NEAR(ratio, 1.0f, 0.05f) << "8-stage allpass decorrelator changed magnitude";
+}
+
+TEST(DecorrelatorTest, PairMatchesTwoDecorrelators) {
+    for (int numStages : {1, kDefaultDecorrStages, kMaxDecorrStages}) {
+        Decorrelator referenceA;
+        Decorrelator referenceB;
+        DecorrelatorPair pair;
+        referenceA.prepare(44100.0, kDecorrDelaysX, numStages);
+        referenceB.prepare(44100.0, kDecorrDelaysZ, numStages);
+        pair.prepare(44100.0, kDecorrDelaysX, kDecorrDelaysZ, numStages);
+        EXPECT_EQ(pair.getTailSamples(kTailThreshold),
+                  std::max(referenceA.getTailSamples(kTailThreshold),
+                           referenceB.getTailSamples(kTailThreshold)));
+
+        // Alternate per-sample and block calls of odd sizes, with the
+        // input aliased to lane B as in the encoder
+        constexpr int numSamples = 6000;
+        std::vector<float> input(numSamples), outA(numSamples), outB(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            input[static_cast<size_t>(i)] = 0.5f * std::sin(2.0f * kPi * 330.0f * static_cast<float>(i) / 44100.0f)
+                                          + 0.3f * std::sin(2.0f * kPi * 5100.0f * static_cast<float>(i) / 44100.0f);
+
+        int blockSizes[] = {1, 37, 64, 300, 513};
+        int pos = 0;
+        for (int bi = 0; pos < numSamples; bi = (bi + 1) % 5) {
+            int n = std::min(blockSizes[bi], numSamples - pos);
+            auto offset = static_cast<size_t>(pos);
+            if (n == 1) {
+                pair.process(input[offset], outA[offset], outB[offset]);
+            } else {
+                std::copy_n(&input[offset], n, &outB[offset]);
+                pair.processBlock(&outB[offset], &outA[offset], &outB[offset], n);
+            }
+            pos += n;
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            float refA = referenceA.process(input[static_cast<size_t>(i)]);
+            float refB = referenceB.process(input[static_cast<size_t>(i)]);
+            ASSERT_FLOAT_EQ(outA[static_cast<size_t>(i)], refA)
+                << "Lane A mismatch at sample " << i << " with " << numStages << " stages";
+            ASSERT_FLOAT_EQ(outB[static_cast<size_t>(i)], refB)
+                << "Lane B mismatch at sample " << i << " with " << numStages << " stages";
+        }
+    }
+}
+
 // ===== AnalysisBand tests =====
 
 TEST(AnalysisBandTest, MonoSignalProducesHighICC) {
@@ -515,6 +598,149 @@ TEST(AnalysisBandTest, EnergyIsNonNegative) {
     }
 }
 
+// ===== BiquadBank tests =====
+
+// Every lane of a bank must match its own Biquad, through block and
+// per-lane sample calls alike
+template <int N>
+static void expectBankMatchesBiquads() {
+    BiquadBank<N> bank;
+    Biquad reference[static_cast<size_t>(N)];
+    for (int lane = 0; lane < N; ++lane) {
+        float freq = 80.0f * static_cast<float>(lane + 1) * static_cast<float>(lane + 1);
+        auto c = lane % 2 == 0 ? BiquadCoefficients::makeLowPass(48000.0, freq)
+                               : BiquadCoefficients::makeHighPass(48000.0, freq, 0.5f);
+        bank.setCoefficients(lane, c);
+        reference[lane].setCoefficients(c);
+    }
+
+    constexpr int maxBlock = 61;
+    std::vector<float> frames(static_cast<size_t>(maxBlock * N));
+    int t = 0;
+    for (int round = 0; round < 30; ++round) {
+        int n = 1 + (round * 23) % maxBlock;
+        for (int s = 0; s < n; ++s) {
+            for (int lane = 0; lane < N; ++lane) {
+                float freq = 100.0f * static_cast<float>(lane + 1) + 1500.0f * static_cast<float>(lane % 3);
+                frames[static_cast<size_t>(s * N + lane)] = 0.5f * std::sin(2.0f * kPi * freq * static_cast<float>(t + s) / 48000.0f);
+            }
+        }
+
+        std::vector<float> expected(frames.begin(), frames.begin() + n * N);
+        for (int s = 0; s < n; ++s) {
+            for (int lane = 0; lane < N; ++lane) {
+                auto& v = expected[static_cast<size_t>(s * N + lane)];
+                v = reference[lane].processSample(v);
+            }
+        }
+
+        if (round % 3 == 2) {
+            for (int s = 0; s < n; ++s) {
+                for (int lane = 0; lane < N; ++lane) {
+                    auto& v = frames[static_cast<size_t>(s * N + lane)];
+                    v = bank.processSample(lane, v);
+                }
+            }
+        } else {
+            bank.processBlock(frames.data(), frames.data(), n);
+        }
+
+        for (int i = 0; i < n * N; ++i) {
+            ASSERT_NEAR(frames[static_cast<size_t>(i)], expected[static_cast<size_t>(i)], 1e-6f)
+                << N << " lanes, round " << round << " sample " << i / N << " lane " << i % N;
+        }
+        t += n;
+    }
+}
+
+TEST(BiquadBankTest, LanesMatchIndependentBiquads) {
+    expectBankMatchesBiquads<1>();
+    expectBankMatchesBiquads<4>();
+    expectBankMatchesBiquads<8>();
+}
+
+// The block form against the recursion. Both round in float, most of all
+// for the lowest crossover at 192 kHz, where its poles sit closest to
+// z = 1, so each is measured against the recursion in double: the block
+// form must stay about as close to it as the float Biquad does (within a
+// factor of two; it is closer on most filters). Blocks of every
+// length exercise the recursive remainder and the hand-over between them.
+template <int N>
+static void expectBlockBankMatchesBiquads(double sampleRate, float crossoverFreq) {
+    BlockBiquadBank<N> bank;
+    Biquad reference[static_cast<size_t>(N)];
+    BiquadCoefficients coeffs[static_cast<size_t>(N)];
+    for (int f = 0; f < N; ++f) {
+        coeffs[f] = f == 0 ? BiquadCoefficients::makeLowPass(sampleRate, crossoverFreq, 0.5f)
+                           : BiquadCoefficients::makeHighPass(sampleRate, crossoverFreq, 0.5f);
+        bank.setCoefficients(f, coeffs[f]);
+        reference[f].setCoefficients(coeffs[f]);
+    }
+
+    constexpr int maxBlock = 61;
+    std::vector<float> input(maxBlock);
+    std::vector<std::vector<float>> outputs(static_cast<size_t>(N), std::vector<float>(maxBlock));
+    float* outputPtrs[static_cast<size_t>(N)];
+    for (int f = 0; f < N; ++f)
+        outputPtrs[f] = outputs[static_cast<size_t>(f)].data();
+
+    double exact[static_cast<size_t>(N)][2] = {};  // transposed direct form II state
+    double blockError[static_cast<size_t>(N)] = {};
+    double recursiveError[static_cast<size_t>(N)] = {};
+    int t = 0;
+    for (int round = 0; round < 300; ++round) {
+        int n = 1 + (round * 23) % maxBlock;
+        for (int s = 0; s < n; ++s) {
+            float time = static_cast<float>(t + s) / static_cast<float>(sampleRate);
+            input[static_cast<size_t>(s)] = 0.6f * std::sin(2.0f * kPi * 70.0f * time)
+                                          + 0.3f * std::sin(2.0f * kPi * 3100.0f * time);
+        }
+
+        if (round % 5 == 4) {
+            for (int s = 0; s < n; ++s) {
+                float y[static_cast<size_t>(N)];
+                bank.processSample(input[static_cast<size_t>(s)], y);
+                for (int f = 0; f < N; ++f)
+                    outputPtrs[f][s] = y[f];
+            }
+        } else {
+            bank.processBlock(input.data(), outputPtrs, n);
+        }
+
+        for (int s = 0; s < n; ++s) {
+            float x = input[static_cast<size_t>(s)];
+            auto xd = static_cast<double>(x);
+            for (int f = 0; f < N; ++f) {
+                const auto& c = coeffs[f];
+                auto& state = exact[f];
+                double y = static_cast<double>(c.b0) * xd + state[0];
+                state[0] = static_cast<double>(c.b1) * xd - static_cast<double>(c.a1) * y + state[1];
+                state[1] = static_cast<double>(c.b2) * xd - static_cast<double>(c.a2) * y;
+
+                float recursive = reference[f].processSample(x);
+                blockError[f] = std::max(blockError[f], std::abs(static_cast<double>(outputPtrs[f][s]) - y));
+                recursiveError[f] = std::max(recursiveError[f], std::abs(static_cast<double>(recursive) - y));
+            }
+        }
+        t += n;
+    }
+
+    for (int f = 0; f < N; ++f) {
+        EXPECT_LE(blockError[f], 2.0 * recursiveError[f] + 1.0e-7)
+            << N << " filters at " << sampleRate << " Hz, " << crossoverFreq << " Hz filter " << f
+            << ": block " << blockError[f] << ", recursive " << recursiveError[f];
+    }
+}
+
+TEST(BlockBiquadBankTest, MatchesRecursiveBiquads) {
+    for (double sampleRate : {48000.0, 192000.0}) {
+        for (float freq : kCrossoverFreqs) {
+            expectBlockBankMatchesBiquads<1>(sampleRate, freq);
+            expectBlockBankMatchesBiquads<2>(sampleRate, freq);
+        }
+    }
+}
+
 // ===== FilterBank tests =====
 
 TEST(FilterBankTest, AllBandsReceiveEnergyFromBroadbandNoise) {
@@ -608,6 +834,151 @@ TEST(FilterBankTest, HighFreqInHighestBand) {
     }
 }
 
+// The same properties for the parallel topology, plus its SIMD block path
+// against the scalar reference.
+
+static std::array<float, kNumBands> parallelBandEnergies(const std::vector<float>& signal) {
+    FilterBank filterBank;
+    filterBank.prepare(48000.0, FilterBankTopology::Parallel);
+
+    std::array<float, kNumBands> energy{};
+    float bandL[kNumBands];
+    float bandR[kNumBands];
+    for (size_t i = 0; i < signal.size(); ++i) {
+        filterBank.process(signal[i], signal[i], bandL, bandR);
+        if (i >= signal.size() / 2) {
+            for (int b = 0; b < kNumBands; ++b)
+                energy[static_cast<size_t>(b)] += bandL[b] * bandL[b];
+        }
+    }
+    return energy;
+}
+
+static std::vector<float> sineSignal(float freq, int numSamples) {
+    std::vector<float> signal(static_cast<size_t>(numSamples));
+    for (int i = 0; i < numSamples; ++i)
+        signal[static_cast<size_t>(i)] = std::sin(2.0f * kPi * freq * static_cast<float>(i) / 48000.0f);
+    return signal;
+}
+
+TEST(FilterBankTest, ParallelAllBandsReceiveEnergyFromBroadbandNoise) {
+    uint32_t seed = 12345;
+    std::vector<float> noise(20000);
+    for (auto& v : noise) {
+        seed = seed * 1664525u + 1013904223u;
+        v = (static_cast<float>(seed) / static_cast<float>(UINT32_MAX)) * 2.0f - 1.0f;
+    }
+
+    auto energy = parallelBandEnergies(noise);
+    for (int b = 0; b < kNumBands; ++b)
+        EXPECT_GT(energy[static_cast<size_t>(b)], 0.001f) << "Band " << b;
+}
+
+TEST(FilterBankTest, ParallelLowFreqInLowestBand) {
+    auto energy = parallelBandEnergies(sineSignal(50.0f, 20000));
+    for (int b = 1; b < kNumBands; ++b)
+        EXPECT_GT(energy[0], energy[static_cast<size_t>(b)]) << "Band " << b;
+}
+
+TEST(FilterBankTest, ParallelHighFreqInHighestBand) {
+    auto energy = parallelBandEnergies(sineSignal(20000.0f, 20000));
+    for (int b = 0; b < kNumBands - 1; ++b)
+        EXPECT_GT(energy[kNumBands - 1], energy[static_cast<size_t>(b)]) << "Band " << b;
+}
+
+TEST(FilterBankTest, ParallelBlockMatchesScalarReference) {
+    FilterBank reference;
+    FilterBank simd;
+    reference.prepare(48000.0, FilterBankTopology::Parallel);
+    simd.prepare(48000.0, FilterBankTopology::Parallel);
+
+    constexpr int blockSize = 61;
+    std::vector<std::vector<float>> bands(2 * kNumBands, std::vector<float>(blockSize));
+    float* bandPtrs[2 * kNumBands];
+    for (int b = 0; b < 2 * kNumBands; ++b) bandPtrs[b] = bands[static_cast<size_t>(b)].data();
+
+    std::vector<float> inL(blockSize), inR(blockSize);
+    for (int block = 0; block < 50; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            int t = block * blockSize + i;
+            inL[static_cast<size_t>(i)] = std::sin(2.0f * kPi * 180.0f * static_cast<float>(t) / 48000.0f)
+                                        + 0.3f * std::sin(2.0f * kPi * 6000.0f * static_cast<float>(t) / 48000.0f);
+            inR[static_cast<size_t>(i)] = std::sin(2.0f * kPi * 1200.0f * static_cast<float>(t) / 48000.0f);
+        }
+
+        simd.processBlock(inL.data(), inR.data(), blockSize, bandPtrs, bandPtrs + kNumBands);
+
+        for (int i = 0; i < blockSize; ++i) {
+            float refL[kNumBands], refR[kNumBands];
+            reference.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], refL, refR);
+            for (int b = 0; b < kNumBands; ++b) {
+                ASSERT_NEAR(bands[static_cast<size_t>(b)][static_cast<size_t>(i)], refL[b], 1e-6f)
+                    << "L band " << b << " block " << block << " sample " << i;
+                ASSERT_NEAR(bands[static_cast<size_t>(kNumBands + b)][static_cast<size_t>(i)], refR[b], 1e-6f)
+                    << "R band " << b << " block " << block << " sample " << i;
+            }
+        }
+    }
+}
+
+// The time-parallel cascade against the recursive one: block, interleaved
+// and per-sample calls, with block lengths that are not whole steps. The
+// two round differently, most on the low crossovers, so they agree to
+// float rounding noise accumulated through the cascade, not bit for bit
+// (BlockBiquadBankTest pins the accuracy of each filter).
+TEST(FilterBankTest, TimeParallelMatchesCascade) {
+    constexpr double sampleRate = 48000.0;
+    FilterBank reference;
+    FilterBank timeParallel;
+    reference.prepare(sampleRate, FilterBankTopology::Cascade);
+    timeParallel.prepare(sampleRate, FilterBankTopology::CascadeTimeParallel);
+    EXPECT_EQ(timeParallel.getTailSamples(kTailThreshold), reference.getTailSamples(kTailThreshold));
+
+    constexpr int maxBlock = 150;
+    std::vector<std::vector<float>> bands(2 * kNumBands, std::vector<float>(maxBlock));
+    float* bandPtrs[2 * kNumBands];
+    for (int b = 0; b < 2 * kNumBands; ++b) bandPtrs[b] = bands[static_cast<size_t>(b)].data();
+    std::vector<float> framesL(maxBlock * kNumBands), framesR(maxBlock * kNumBands);
+
+    std::vector<float> inL(maxBlock), inR(maxBlock);
+    int t = 0;
+    for (int block = 0; block < 40; ++block) {
+        int n = 1 + (block * 37) % maxBlock;
+        for (int i = 0; i < n; ++i) {
+            float time = static_cast<float>(t + i) / static_cast<float>(sampleRate);
+            inL[static_cast<size_t>(i)] = std::sin(2.0f * kPi * 90.0f * time)
+                                        + 0.3f * std::sin(2.0f * kPi * 6000.0f * time);
+            inR[static_cast<size_t>(i)] = std::sin(2.0f * kPi * 1200.0f * time);
+        }
+
+        int mode = block % 3;
+        if (mode == 0)
+            timeParallel.processBlock(inL.data(), inR.data(), n, bandPtrs, bandPtrs + kNumBands);
+        else if (mode == 1)
+            timeParallel.processBlockInterleaved(inL.data(), inR.data(), n, framesL.data(), framesR.data());
+
+        for (int i = 0; i < n; ++i) {
+            float refL[kNumBands], refR[kNumBands];
+            float outL[kNumBands], outR[kNumBands];
+            reference.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], refL, refR);
+            if (mode == 2)
+                timeParallel.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], outL, outR);
+            for (int b = 0; b < kNumBands; ++b) {
+                if (mode == 0) {
+                    outL[b] = bands[static_cast<size_t>(b)][static_cast<size_t>(i)];
+                    outR[b] = bands[static_cast<size_t>(kNumBands + b)][static_cast<size_t>(i)];
+                } else if (mode == 1) {
+                    outL[b] = framesL[static_cast<size_t>(i * kNumBands + b)];
+                    outR[b] = framesR[static_cast<size_t>(i * kNumBands + b)];
+                }
+                ASSERT_NEAR(outL[b], refL[b], 1e-4f) << "L band " << b << " block " << block << " sample " << i;
+                ASSERT_NEAR(outR[b], refR[b], 1e-4f) << "R band " << b << " block " << block << " sample " << i;
+            }
+        }
+        t += n;
+    }
+}
+
 // ===== HeightEstimator tests =====
 
 TEST(HeightEstimatorTest, HFOnlySignalProducesHighElevation) {
@@ -994,6 +1365,34 @@ TEST(ClickFreeTest, LayoutSwitchDuringPlayback) {
         << "Layout switch produced sample > 1.0: " << maxSample;
 }
 
+TEST(ClickFreeTest, LayoutSwitchMidCrossfadeIsContinuous) {
+    // A constant sound field: any jump in the outputs comes from the decoder
+    AmbisonicDecoder decoder;
+    decoder.prepare(48000.0, SpeakerLayout::Surround51);
+    const float bFormat[kNumAmbiChannels] = {0.5f, 0.3f, 0.4f, 0.2f};
+
+    float prev[kMaxOutputChannels];
+    for (int i = 0; i < 4800; ++i)  // let the LFE filter settle
+        decoder.decode(bFormat, SpeakerLayout::Surround51, prev);
+
+    // Change layout twice more before each crossfade completes
+    float maxStep = 0.0f;
+    for (int i = 0; i < 4800; ++i) {
+        SpeakerLayout layout = i < 300 ? SpeakerLayout::Surround222
+                             : i < 500 ? SpeakerLayout::Stereo
+                             : SpeakerLayout::Surround714;
+        float outputs[kMaxOutputChannels];
+        decoder.decode(bFormat, layout, outputs);
+        for (int ch = 0; ch < kMaxOutputChannels; ++ch) {
+            maxStep = std::max(maxStep, std::abs(outputs[ch] - prev[ch]));
+            prev[ch] = outputs[ch];
+        }
+    }
+
+    // One matrix update moves at most 1/60 of the way across a crossfade
+    EXPECT_LT(maxStep, 0.05f) << "Layout change produced a jump of " << maxStep;
+}
+
 // ===== Dry/Wet Test =====
 // Main stereo (1-2) stays dry passthrough.
 // At 0% wet: aux outputs are silent.
@@ -1123,6 +1522,34 @@ TEST(DryWetTest, AuxRoutingPreservesAllWetChannels) {
     }
 }
 
+TEST(DryWetTest, SettledZeroWetZeroFillsWithoutReadingFeeds) {
+    OutputWriter writer;
+    writer.prepare(48000.0);
+
+    constexpr int blockSize = 512;
+    constexpr int numOut = 4;
+    std::vector<float> dryL(blockSize, 0.3f), dryR(blockSize, -0.3f);
+    std::vector<std::vector<float>> speakers(numOut - 2, std::vector<float>(blockSize, 0.5f));
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(blockSize));
+    const float* speakerPtrs[numOut - 2] = {speakers[0].data(), speakers[1].data()};
+    float* outPtrs[numOut] = {out[0].data(), out[1].data(), out[2].data(), out[3].data()};
+
+    // Fade wet out, then feed NaNs: a settled 0% wet must not touch them
+    for (int block = 0; block < 100; ++block)
+        writer.writeBlock(speakerPtrs, dryL.data(), dryR.data(), blockSize, 0.0f, 0.0f, numOut, outPtrs);
+
+    for (auto& feed : speakers)
+        std::fill(feed.begin(), feed.end(), std::numeric_limits<float>::quiet_NaN());
+    writer.writeBlock(speakerPtrs, dryL.data(), dryR.data(), blockSize, 0.0f, 0.0f, numOut, outPtrs);
+
+    for (int i = 0; i < blockSize; ++i) {
+        EXPECT_FLOAT_EQ(out[0][static_cast<size_t>(i)], 0.3f);
+        EXPECT_FLOAT_EQ(out[1][static_cast<size_t>(i)], -0.3f);
+        ASSERT_EQ(out[2][static_cast<size_t>(i)], 0.0f) << "sample " << i;
+        ASSERT_EQ(out[3][static_cast<size_t>(i)], 0.0f) << "sample " << i;
+    }
+}
+
 // ===== LFE Lowpass Test =====
 // Verify LFE channel has lowpassed content (more energy at low freq than high freq)
 
@@ -1361,10 +1788,1816 @@ TEST(GainTest, NoSampleExceedsOnePointZeroDuringGainTransition) {
         << "Dry main output should not be impacted by gain transitions";
 }
 
-// ===== Plugin instantiation test =====
+TEST(GainTest, SettledGainIsOneConstantMultiplier) {
+    OutputWriter writer;
+    writer.prepare(48000.0);
+
+    constexpr int numSamples = 48000;
+    constexpr int numOut = 4;
+    std::vector<float> dry(numSamples, 0.0f);
+    std::vector<std::vector<float>> speakers(numOut - 2, std::vector<float>(numSamples));
+    for (int i = 0; i < numSamples; ++i) {
+        speakers[0][static_cast<size_t>(i)] = 0.5f * std::sin(2.0f * kPi * 440.0f * static_cast<float>(i) / 48000.0f);
+        speakers[1][static_cast<size_t>(i)] = 0.25f;
+    }
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(numSamples));
+    const float* speakerPtrs[numOut - 2] = {speakers[0].data(), speakers[1].data()};
+    float* outPtrs[numOut] = {out[0].data(), out[1].data(), out[2].data(), out[3].data()};
+
+    writer.writeBlock(speakerPtrs, dry.data(), dry.data(), numSamples, 0.5f, -12.0f, numOut, outPtrs);
+
+    // While ramping, a constant input moves in straight lines within each
+    // segment (no steps between samples)
+    for (int i = 1; i + 1 < kGainRampLength; ++i) {
+        float curvature = out[3][static_cast<size_t>(i + 1)] - 2.0f * out[3][static_cast<size_t>(i)]
+                        + out[3][static_cast<size_t>(i - 1)];
+        ASSERT_NEAR(curvature, 0.0f, 1e-6f) << "sample " << i;
+    }
+
+    // After ~0.5 s both smoothers have settled: every sample gets exactly the
+    // target multiplier
+    const float multiplier = 0.5f * hot::dbToGain(-12.0f);
+    for (int i = numSamples / 2; i < numSamples; ++i) {
+        ASSERT_EQ(out[2][static_cast<size_t>(i)], speakers[0][static_cast<size_t>(i)] * multiplier) << "sample " << i;
+        ASSERT_EQ(out[3][static_cast<size_t>(i)], 0.25f * multiplier) << "sample " << i;
+    }
+}
+
+// ===== Block processing tests =====
+// Block stages must match the per-sample reference path within float tolerance.
+
+static float testSignal(int i, float freq, float amp, float sampleRate = 48000.0f) {
+    return amp * std::sin(2.0f * kPi * freq * static_cast<float>(i) / sampleRate);
+}
+
+TEST(BlockProcessingTest, SpatialAnalyzerIsChunkSizeInvariant) {
+    // process() is processBlock() over one sample, so this checks chunk-size
+    // invariance for each analysis mode; SpatialAnalyzerMatchesScalarBandReference
+    // checks the values
+    struct Mode {
+        const char* name;
+        AnalysisConfig config;
+        double sampleRate;
+    };
+    AnalysisConfig controlRate;
+    controlRate.controlInterval = 16;
+    AnalysisConfig multirate;
+    multirate.multirate = true;
+    AnalysisConfig stft;
+    stft.engine = AnalysisEngine::Stft;
+    const Mode modes[] = {
+        {"per-sample", {}, 48000.0},
+        {"control-rate", controlRate, 48000.0},
+        {"multirate", multirate, 96000.0},
+        {"stft", stft, 48000.0},
+    };
+
+    for (const Mode& mode : modes) {
+        SCOPED_TRACE(mode.name);
+        SpatialAnalyzer oneSample;
+        SpatialAnalyzer chunked;
+        oneSample.prepare(mode.sampleRate, mode.config);
+        chunked.prepare(mode.sampleRate, mode.config);
+
+        const float rate = static_cast<float>(mode.sampleRate);
+        constexpr int numSamples = 4000;
+        std::vector<float> inL(numSamples), inR(numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            inL[static_cast<size_t>(i)] = testSignal(i, 440.0f, 0.5f, rate) + testSignal(i, 7000.0f, 0.2f, rate);
+            inR[static_cast<size_t>(i)] = testSignal(i, 440.0f, 0.3f, rate) - testSignal(i, 3000.0f, 0.2f, rate);
+        }
+
+        // Odd block sizes exercise the sub-block split
+        std::vector<SpatialParams> params(numSamples);
+        int blockSizes[] = {1, 37, 64, 100, 513};
+        int pos = 0;
+        for (int bi = 0; pos < numSamples; bi = (bi + 1) % 5) {
+            int n = std::min(blockSizes[bi], numSamples - pos);
+            chunked.processBlock(&inL[static_cast<size_t>(pos)], &inR[static_cast<size_t>(pos)], n,
+                                 &params[static_cast<size_t>(pos)]);
+            pos += n;
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            SpatialParams ref = oneSample.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)]);
+            const auto& p = params[static_cast<size_t>(i)];
+            ASSERT_NEAR(p.icc, ref.icc, 1e-6f) << "ICC mismatch at sample " << i;
+            ASSERT_NEAR(p.azimuth, ref.azimuth, 1e-6f) << "Azimuth mismatch at sample " << i;
+            ASSERT_NEAR(p.diffuseness, ref.diffuseness, 1e-6f) << "Diffuseness mismatch at sample " << i;
+            ASSERT_NEAR(p.elevation, ref.elevation, 1e-6f) << "Elevation mismatch at sample " << i;
+        }
+    }
+}
+
+TEST(BlockProcessingTest, SpatialAnalyzerMatchesScalarBandReference) {
+    // Reference: scalar filter bank, one AnalysisBand per band, then the
+    // energy-weighted aggregation and height estimate, sample by sample
+    FilterBank filterBank;
+    AnalysisBand bands[kNumBands];
+    HeightEstimator height;
+    filterBank.prepare(48000.0);
+    for (auto& band : bands)
+        band.prepare(48000.0);
+    height.prepare(48000.0);
+
+    SpatialAnalyzer analyzer;
+    analyzer.prepare(48000.0);
+
+    constexpr int numSamples = 4800;
+    std::vector<float> inL(numSamples), inR(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        inL[static_cast<size_t>(i)] = testSignal(i, 200.0f, 0.6f) + testSignal(i, 9000.0f, 0.1f);
+        inR[static_cast<size_t>(i)] = testSignal(i, 200.0f, 0.2f) - testSignal(i, 2500.0f, 0.4f);
+    }
+
+    std::vector<SpatialParams> params(numSamples);
+    analyzer.processBlock(inL.data(), inR.data(), numSamples, params.data());
+
+    for (int i = 0; i < numSamples; ++i) {
+        float bandL[kNumBands], bandR[kNumBands], energies[kNumBands];
+        filterBank.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], bandL, bandR);
+
+        float totalEnergy = kEpsilon, weightedICC = 0.0f, weightedAzimuth = 0.0f;
+        for (int b = 0; b < kNumBands; ++b) {
+            BandAnalysis result = bands[b].process(bandL[b], bandR[b]);
+            energies[b] = result.energy;
+            totalEnergy += result.energy;
+            weightedICC += result.energy * result.icc;
+            weightedAzimuth += result.energy * result.azimuth;
+        }
+        float icc = weightedICC / totalEnergy;
+        float elevation = height.process(energies);
+
+        const auto& p = params[static_cast<size_t>(i)];
+        ASSERT_NEAR(p.icc, icc, 1e-5f) << "ICC mismatch at sample " << i;
+        ASSERT_NEAR(p.azimuth, weightedAzimuth / totalEnergy, 1e-5f) << "Azimuth mismatch at sample " << i;
+        ASSERT_NEAR(p.diffuseness, std::sqrt(1.0f - std::clamp(icc, 0.0f, 1.0f)), 1e-4f)
+            << "Diffuseness mismatch at sample " << i;
+        ASSERT_NEAR(p.elevation, elevation, 1e-5f) << "Elevation mismatch at sample " << i;
+    }
+}
+
+TEST(BlockProcessingTest, FilterBankSimdBlockMatchesScalarReference) {
+    FilterBank reference;
+    FilterBank simd;
+    reference.prepare(48000.0);
+    simd.prepare(48000.0);
+
+    constexpr int maxBlock = 97;
+    std::vector<std::vector<float>> bands(2 * kNumBands, std::vector<float>(maxBlock));
+    float* bandPtrs[2 * kNumBands];
+    for (int b = 0; b < 2 * kNumBands; ++b) bandPtrs[b] = bands[static_cast<size_t>(b)].data();
+
+    // Alternate block and per-sample calls on the SIMD instance: the paired
+    // lanes must hand their state back to the scalar filters exactly
+    int t = 0;
+    for (int round = 0; round < 60; ++round) {
+        int n = 1 + (round * 37) % maxBlock;
+        std::vector<float> inL(static_cast<size_t>(n)), inR(static_cast<size_t>(n));
+        for (int i = 0; i < n; ++i, ++t) {
+            inL[static_cast<size_t>(i)] = testSignal(t, 90.0f, 0.5f) + testSignal(t, 9000.0f, 0.2f);
+            inR[static_cast<size_t>(i)] = testSignal(t, 700.0f, 0.4f) - testSignal(t, 2500.0f, 0.3f);
+        }
+
+        if (round % 3 == 2) {
+            for (int i = 0; i < n; ++i) {
+                float refL[kNumBands], refR[kNumBands], simdL[kNumBands], simdR[kNumBands];
+                reference.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], refL, refR);
+                simd.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], simdL, simdR);
+                for (int b = 0; b < kNumBands; ++b) {
+                    ASSERT_NEAR(simdL[b], refL[b], 1e-6f) << "Band " << b << " round " << round;
+                    ASSERT_NEAR(simdR[b], refR[b], 1e-6f) << "Band " << b << " round " << round;
+                }
+            }
+            continue;
+        }
+
+        simd.processBlock(inL.data(), inR.data(), n, bandPtrs, bandPtrs + kNumBands);
+        for (int i = 0; i < n; ++i) {
+            float refL[kNumBands], refR[kNumBands];
+            reference.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], refL, refR);
+            for (int b = 0; b < kNumBands; ++b) {
+                ASSERT_NEAR(bands[static_cast<size_t>(b)][static_cast<size_t>(i)], refL[b], 1e-6f)
+                    << "L band " << b << " round " << round << " sample " << i;
+                ASSERT_NEAR(bands[static_cast<size_t>(kNumBands + b)][static_cast<size_t>(i)], refR[b], 1e-6f)
+                    << "R band " << b << " round " << round << " sample " << i;
+            }
+        }
+    }
+}
+
+TEST(BlockProcessingTest, EncoderAndDecoderBlockMatchPerSample) {
+    AmbisonicEncoder refEncoder, blockEncoder;
+    AmbisonicDecoder refDecoder, blockDecoder;
+    refEncoder.prepare(48000.0);
+    blockEncoder.prepare(48000.0);
+    refDecoder.prepare(48000.0, SpeakerLayout::Surround51);
+    blockDecoder.prepare(48000.0, SpeakerLayout::Surround51);
+
+    constexpr int blockSize = 256;
+    constexpr int numSpeakers = 24;
+    SpeakerLayout layouts[] = {
+        SpeakerLayout::Surround51, SpeakerLayout::Surround222,
+        SpeakerLayout::Stereo, SpeakerLayout::Surround714
+    };
+
+    std::vector<float> inL(blockSize), inR(blockSize);
+    std::vector<SpatialParams> params(blockSize);
+    std::vector<std::vector<float>> bFormat(kNumAmbiChannels, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> speakers(numSpeakers, std::vector<float>(blockSize));
+    float* bFormatPtrs[kNumAmbiChannels];
+    float* speakerPtrs[numSpeakers];
+    for (int ch = 0; ch < kNumAmbiChannels; ++ch) bFormatPtrs[ch] = bFormat[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < numSpeakers; ++ch) speakerPtrs[ch] = speakers[static_cast<size_t>(ch)].data();
+
+    for (int block = 0; block < 40; ++block) {
+        // Switch layout every 10 blocks to cover the crossfade path
+        SpeakerLayout layout = layouts[block / 10];
+
+        for (int i = 0; i < blockSize; ++i) {
+            int t = block * blockSize + i;
+            inL[static_cast<size_t>(i)] = testSignal(t, 220.0f, 0.5f);
+            inR[static_cast<size_t>(i)] = testSignal(t, 330.0f, 0.4f);
+            params[static_cast<size_t>(i)] = SpatialParams{0.6f, 0.2f, 0.63f, 0.1f};
+        }
+
+        blockEncoder.encodeBlock(inL.data(), inR.data(), params.data(), blockSize, bFormatPtrs);
+        blockDecoder.decodeBlock(bFormatPtrs, blockSize, layout, speakerPtrs, numSpeakers);
+
+        for (int i = 0; i < blockSize; ++i) {
+            float refB[kNumAmbiChannels];
+            float refSpeakers[kMaxOutputChannels];
+            refEncoder.encode(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)],
+                              params[static_cast<size_t>(i)], refB);
+            refDecoder.decode(refB, layout, refSpeakers);
+
+            for (int ch = 0; ch < kNumAmbiChannels; ++ch) {
+                ASSERT_NEAR(bFormat[static_cast<size_t>(ch)][static_cast<size_t>(i)], refB[ch], 1e-6f)
+                    << "B-format ch " << ch << " mismatch in block " << block << " sample " << i;
+            }
+            for (int spk = 0; spk < numSpeakers; ++spk) {
+                ASSERT_NEAR(speakers[static_cast<size_t>(spk)][static_cast<size_t>(i)], refSpeakers[spk], 1e-6f)
+                    << "Speaker " << spk << " mismatch in block " << block << " sample " << i;
+            }
+        }
+    }
+}
+
+TEST(BlockProcessingTest, SpecialisedDecodeMatchesMatrixForEveryLayout) {
+    constexpr int blockSize = 64;
+    std::vector<std::vector<float>> bFormat(kNumAmbiChannels, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> speakers(kMaxOutputChannels, std::vector<float>(blockSize));
+    const float* bFormatPtrs[kNumAmbiChannels];
+    float* speakerPtrs[kMaxOutputChannels];
+    for (int ch = 0; ch < kNumAmbiChannels; ++ch) {
+        bFormatPtrs[ch] = bFormat[static_cast<size_t>(ch)].data();
+        for (int i = 0; i < blockSize; ++i)
+            bFormat[static_cast<size_t>(ch)][static_cast<size_t>(i)] =
+                testSignal(i, 110.0f * static_cast<float>(ch + 1), 0.5f);
+    }
+    for (int ch = 0; ch < kMaxOutputChannels; ++ch) speakerPtrs[ch] = speakers[static_cast<size_t>(ch)].data();
+
+    for (int l = 0; l < static_cast<int>(SpeakerLayout::kNumLayouts); ++l) {
+        auto layout = static_cast<SpeakerLayout>(l);
+        const auto& info = getLayoutInfo(layout);
+        AmbisonicDecoder decoder;
+        decoder.prepare(48000.0, layout);
+        decoder.decodeBlock(bFormatPtrs, blockSize, layout, speakerPtrs, kMaxOutputChannels);
+
+        for (int spk = 0; spk < kMaxOutputChannels; ++spk) {
+            if (spk == info.lfeChannelIndex)
+                continue;  // LFE is the lowpassed W feed, not a matrix row
+            for (int i = 0; i < blockSize; ++i) {
+                float expected = 0.0f;
+                if (spk < info.numChannels) {
+                    for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+                        expected += info.decoderMatrix[spk * kNumAmbiChannels + ch]
+                                    * bFormat[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+                }
+                ASSERT_NEAR(speakers[static_cast<size_t>(spk)][static_cast<size_t>(i)], expected, 1e-6f)
+                    << info.name << " speaker " << spk << " sample " << i;
+            }
+        }
+    }
+}
+
+TEST(BlockProcessingTest, OutputWriterBlockMatchesPerSample) {
+    OutputWriter refWriter, blockWriter;
+    refWriter.prepare(48000.0);
+    blockWriter.prepare(48000.0);
+
+    constexpr int blockSize = 100;
+    constexpr int numOut = 8;
+    std::vector<std::vector<float>> speakers(numOut - 2, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(blockSize));
+    std::vector<float> dryL(blockSize), dryR(blockSize);
+    const float* speakerPtrs[numOut - 2];
+    float* outPtrs[numOut];
+    for (int ch = 0; ch < numOut - 2; ++ch) speakerPtrs[ch] = speakers[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < numOut; ++ch) outPtrs[ch] = out[static_cast<size_t>(ch)].data();
+
+    for (int block = 0; block < 30; ++block) {
+        float dryWet = (block < 10) ? 1.0f : 0.4f;
+        float gainDb = (block < 20) ? 0.0f : -18.0f;
+
+        for (int i = 0; i < blockSize; ++i) {
+            int t = block * blockSize + i;
+            dryL[static_cast<size_t>(i)] = testSignal(t, 500.0f, 0.5f);
+            dryR[static_cast<size_t>(i)] = testSignal(t, 600.0f, 0.5f);
+            for (int ch = 0; ch < numOut - 2; ++ch)
+                speakers[static_cast<size_t>(ch)][static_cast<size_t>(i)] = testSignal(t + ch * 7, 1000.0f, 0.3f);
+        }
+
+        blockWriter.writeBlock(speakerPtrs, dryL.data(), dryR.data(), blockSize,
+                               dryWet, gainDb, numOut, outPtrs);
+
+        for (int i = 0; i < blockSize; ++i) {
+            float frame[kMaxOutputChannels] = {};
+            for (int ch = 0; ch < numOut - 2; ++ch)
+                frame[ch] = speakers[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+
+            std::array<float, numOut> refOut{};
+            float* refPtrs[numOut];
+            for (int ch = 0; ch < numOut; ++ch) refPtrs[ch] = &refOut[static_cast<size_t>(ch)];
+            refWriter.writeSample(frame, dryL[static_cast<size_t>(i)], dryR[static_cast<size_t>(i)],
+                                  dryWet, gainDb, numOut, refPtrs, 0);
+
+            for (int ch = 0; ch < numOut; ++ch) {
+                ASSERT_NEAR(out[static_cast<size_t>(ch)][static_cast<size_t>(i)],
+                            refOut[static_cast<size_t>(ch)], 1e-6f)
+                    << "Output ch " << ch << " mismatch in block " << block << " sample " << i;
+            }
+        }
+    }
+}
+
+TEST(BlockProcessingTest, PipelineDirectDecodeMatchesSeparateStages) {
+    // The pipeline decodes into the aux outputs with the wet gain fused in;
+    // the reference decodes into scratch and runs writeBlock() on it
+    constexpr int blockSize = 128;
+    constexpr int numOut = 2 + 12;
+    UpmixPipeline pipeline;
+    pipeline.prepare(48000.0, blockSize, SpeakerLayout::Surround714);
 
-TEST(PluginTest, CanInstantiate) {
-    auto plugin = std::make_unique<AudioPluginAudioProcessor>();
-    EXPECT_NE(plugin, nullptr);
-    EXPECT_EQ(plugin->getName(), "UpmixRT");
+    SpatialAnalyzer analyzer;
+    AmbisonicEncoder encoder;
+    AmbisonicDecoder decoder;
+    OutputWriter writer;
+    analyzer.prepare(48000.0);
+    encoder.prepare(48000.0);
+    decoder.prepare(48000.0, SpeakerLayout::Surround714);
+    writer.prepare(48000.0);
+
+    std::vector<float> inL(blockSize), inR(blockSize);
+    std::vector<SpatialParams> params(blockSize);
+    std::vector<std::vector<float>> bFormat(kNumAmbiChannels, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> speakers(numOut - 2, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> refOut(numOut, std::vector<float>(blockSize));
+    float* bFormatPtrs[kNumAmbiChannels];
+    float* speakerPtrs[numOut - 2];
+    float* outPtrs[numOut];
+    float* refPtrs[numOut];
+    for (int ch = 0; ch < kNumAmbiChannels; ++ch) bFormatPtrs[ch] = bFormat[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < numOut - 2; ++ch) speakerPtrs[ch] = speakers[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < numOut; ++ch) {
+        outPtrs[ch] = out[static_cast<size_t>(ch)].data();
+        refPtrs[ch] = refOut[static_cast<size_t>(ch)].data();
+    }
+
+    for (int block = 0; block < 60; ++block) {
+        // Gain and dry/wet automation, a stretch at zero wet and a layout change
+        float dryWet = block < 15 ? 1.0f : block < 30 ? 0.0f : 0.6f;
+        float gainDb = block < 40 ? 0.0f : -12.0f;
+        auto layout = block < 45 ? SpeakerLayout::Surround714 : SpeakerLayout::Surround51;
+
+        for (int i = 0; i < blockSize; ++i) {
+            int t = block * blockSize + i;
+            inL[static_cast<size_t>(i)] = testSignal(t, 220.0f, 0.5f);
+            inR[static_cast<size_t>(i)] = testSignal(t, 330.0f, 0.4f);
+        }
+
+        pipeline.process(inL.data(), inR.data(), outPtrs, numOut, blockSize, layout, dryWet, gainDb);
+
+        analyzer.processBlock(inL.data(), inR.data(), blockSize, params.data());
+        encoder.encodeBlock(inL.data(), inR.data(), params.data(), blockSize, bFormatPtrs);
+        decoder.decodeBlock(bFormatPtrs, blockSize, layout, speakerPtrs, numOut - 2);
+        writer.writeBlock(speakerPtrs, inL.data(), inR.data(), blockSize, dryWet, gainDb,
+                          numOut, refPtrs);
+
+        for (int ch = 0; ch < numOut; ++ch) {
+            for (int i = 0; i < blockSize; ++i) {
+                ASSERT_NEAR(out[static_cast<size_t>(ch)][static_cast<size_t>(i)],
+                            refOut[static_cast<size_t>(ch)][static_cast<size_t>(i)], 1e-6f)
+                    << "Output ch " << ch << " mismatch in block " << block << " sample " << i;
+            }
+        }
+    }
+}
+
+// ===== Control-rate analysis tests =====
+// Control-rate mode must stay within its documented bounds of the per-sample path.
+
+// Runs config against the per-sample reference with the same filter bank
+// topology (parallel for multirate) and checks the control-rate or
+// multirate bounds once the smoothers have settled.
+static void verifyAnalysisBounds(const AnalysisConfig& config, double sampleRate, bool panSweep) {
+    SpatialAnalyzer reference;
+    SpatialAnalyzer analyzer;
+    AnalysisConfig referenceConfig;
+    referenceConfig.filterBankTopology = config.multirate ? FilterBankTopology::Parallel
+                                                          : config.filterBankTopology;
+    reference.prepare(sampleRate, referenceConfig);
+    analyzer.prepare(sampleRate, config);
+
+    const int numSamples = static_cast<int>(sampleRate);
+    const int settleSamples = static_cast<int>(sampleRate / 10.0);
+    const float rate = static_cast<float>(sampleRate);
+    std::vector<float> inL(static_cast<size_t>(numSamples)), inR(static_cast<size_t>(numSamples));
+    uint32_t seed = 12345;
+    auto noise = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+    };
+    // Multirate does not analyse content above 0.4 x the base rate
+    // (19.2 kHz), so its noise is band-limited well below that
+    const int numLowpasses = config.multirate ? 3 : 0;
+    Biquad lowpassA[3], lowpassB[3];
+    for (int k = 0; k < numLowpasses; ++k) {
+        auto coeffs = BiquadCoefficients::makeLowPass(sampleRate, 12000.0f);
+        lowpassA[k].setCoefficients(coeffs);
+        lowpassB[k].setCoefficients(coeffs);
+    }
+    for (int i = 0; i < numSamples; ++i) {
+        float a = noise();
+        float b = noise();
+        for (int k = 0; k < numLowpasses; ++k) {
+            a = lowpassA[k].processSample(a);
+            b = lowpassB[k].processSample(b);
+        }
+        if (panSweep) {
+            float pan = 0.5f + 0.5f * testSignal(i, 0.5f, 1.0f, rate);
+            inL[static_cast<size_t>(i)] = a * (1.0f - pan);
+            inR[static_cast<size_t>(i)] = a * pan;
+        } else {
+            inL[static_cast<size_t>(i)] = a + testSignal(i, 100.0f, 0.3f, rate);
+            inR[static_cast<size_t>(i)] = b + testSignal(i, 8000.0f, 0.3f, rate);
+        }
+    }
+
+    std::vector<SpatialParams> params(static_cast<size_t>(numSamples));
+    analyzer.processBlock(inL.data(), inR.data(), numSamples, params.data());
+
+    float maxICC = 0.0f, maxAzimuth = 0.0f, maxDiffuseness = 0.0f, maxElevation = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        SpatialParams ref = reference.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)]);
+        if (i < settleSamples) continue;
+        const auto& p = params[static_cast<size_t>(i)];
+        maxICC = std::max(maxICC, std::abs(p.icc - ref.icc));
+        maxAzimuth = std::max(maxAzimuth, std::abs(p.azimuth - ref.azimuth));
+        maxDiffuseness = std::max(maxDiffuseness, std::abs(p.diffuseness - ref.diffuseness));
+        maxElevation = std::max(maxElevation, std::abs(p.elevation - ref.elevation));
+    }
+
+    const float iccBound = config.multirate ? kMultirateMaxICCError : kControlRateMaxICCError;
+    const float azimuthBound = config.multirate ? kMultirateMaxAzimuthError : kControlRateMaxAzimuthError;
+    const float elevationBound = config.multirate ? kMultirateMaxElevationError : kControlRateMaxElevationError;
+    EXPECT_LE(maxICC, iccBound) << "ICC error, interval " << config.controlInterval << " at " << sampleRate;
+    EXPECT_LE(maxAzimuth, azimuthBound) << "Azimuth error, interval " << config.controlInterval << " at " << sampleRate;
+    EXPECT_LE(maxDiffuseness, iccBound) << "Diffuseness error, interval " << config.controlInterval << " at " << sampleRate;
+    EXPECT_LE(maxElevation, elevationBound) << "Elevation error, interval " << config.controlInterval << " at " << sampleRate;
+}
+
+static AnalysisConfig makeAnalysisConfig(int controlInterval, bool multirate) {
+    AnalysisConfig config;
+    config.controlInterval = controlInterval;
+    config.multirate = multirate;
+    return config;
+}
+
+TEST(ControlRateTest, Interval16PanSweepWithinBounds) {
+    verifyAnalysisBounds(makeAnalysisConfig(16, false), 48000.0, true);
+}
+
+TEST(ControlRateTest, Interval32PanSweepWithinBounds) {
+    verifyAnalysisBounds(makeAnalysisConfig(32, false), 48000.0, true);
+}
+
+TEST(ControlRateTest, Interval32UncorrelatedNoiseWithinBounds) {
+    verifyAnalysisBounds(makeAnalysisConfig(32, false), 48000.0, false);
+}
+
+// The interpolated paths must not ramp in from zero diffuseness: on silence
+// they match the per-sample analysis from the first sample, also after reset()
+TEST(ControlRateTest, StartsFromSilentParams) {
+    constexpr int numSamples = 1024;
+    std::vector<float> silence(numSamples, 0.0f);
+    std::vector<float> noiseL(numSamples), noiseR(numSamples);
+    uint32_t seed = 99;
+    for (int i = 0; i < numSamples; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        noiseL[static_cast<size_t>(i)] = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+        seed = seed * 1664525u + 1013904223u;
+        noiseR[static_cast<size_t>(i)] = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+    }
+
+    SpatialAnalyzer reference;
+    reference.prepare(48000.0);
+    std::vector<SpatialParams> expected(numSamples);
+    reference.processBlock(silence.data(), silence.data(), numSamples, expected.data());
+
+    AnalysisConfig stft;
+    stft.engine = AnalysisEngine::Stft;
+    for (const auto& config : {makeAnalysisConfig(32, false), makeAnalysisConfig(32, true), stft}) {
+        SpatialAnalyzer analyzer;
+        analyzer.prepare(48000.0, config);
+        std::vector<SpatialParams> params(numSamples);
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 1) {
+                analyzer.processBlock(noiseL.data(), noiseR.data(), numSamples, params.data());
+                analyzer.reset();
+            }
+            analyzer.processBlock(silence.data(), silence.data(), numSamples, params.data());
+            for (int i = 0; i < numSamples; ++i) {
+                const auto& p = params[static_cast<size_t>(i)];
+                const auto& ref = expected[static_cast<size_t>(i)];
+                ASSERT_NEAR(p.icc, ref.icc, 1e-6f) << "pass " << pass << ", sample " << i;
+                ASSERT_NEAR(p.azimuth, ref.azimuth, 1e-6f) << "pass " << pass << ", sample " << i;
+                ASSERT_NEAR(p.diffuseness, ref.diffuseness, 1e-6f) << "pass " << pass << ", sample " << i;
+                ASSERT_NEAR(p.elevation, ref.elevation, 1e-6f) << "pass " << pass << ", sample " << i;
+            }
+        }
+    }
+}
+
+// ===== Multi-stream engine tests =====
+// Each engine stream must produce exactly what a standalone pipeline produces.
+
+static void verifyEngineMatchesPipelines(int numStreams, int numWorkers) {
+    constexpr int blockSize = 256;
+    constexpr int numOut = 8;  // dry stereo + 5.1 wet
+    constexpr int numBlocks = 12;
+
+    UpmixEngine engine;
+    engine.prepare(numStreams, 48000.0, blockSize, SpeakerLayout::Surround51, numWorkers);
+
+    std::vector<UpmixPipeline> references(static_cast<size_t>(numStreams));
+    for (auto& pipeline : references)
+        pipeline.prepare(48000.0, blockSize, SpeakerLayout::Surround51);
+
+    auto channelIndex = [](int stream, int ch) { return static_cast<size_t>(stream * numOut + ch); };
+    std::vector<std::vector<float>> inputs(static_cast<size_t>(numStreams * 2), std::vector<float>(blockSize));
+    std::vector<std::vector<float>> engineOut(static_cast<size_t>(numStreams * numOut), std::vector<float>(blockSize));
+    std::vector<std::vector<float>> refOut(static_cast<size_t>(numStreams * numOut), std::vector<float>(blockSize));
+    std::vector<float*> enginePtrs(engineOut.size());
+    std::vector<float*> refPtrs(refOut.size());
+    for (size_t i = 0; i < engineOut.size(); ++i) {
+        enginePtrs[i] = engineOut[i].data();
+        refPtrs[i] = refOut[i].data();
+    }
+
+    std::vector<UpmixEngine::StreamBlock> blocks(static_cast<size_t>(numStreams));
+    for (int st = 0; st < numStreams; ++st) {
+        auto& block = blocks[static_cast<size_t>(st)];
+        block.inputL = inputs[static_cast<size_t>(st * 2)].data();
+        block.inputR = inputs[static_cast<size_t>(st * 2 + 1)].data();
+        block.outputs = &enginePtrs[channelIndex(st, 0)];
+        block.numOutputChannels = numOut;
+        block.dryWetTarget = 0.5f + 0.05f * static_cast<float>(st);
+    }
+
+    for (int b = 0; b < numBlocks; ++b) {
+        for (int st = 0; st < numStreams; ++st) {
+            for (int i = 0; i < blockSize; ++i) {
+                int t = b * blockSize + i;
+                float freq = 100.0f * static_cast<float>(st + 1);
+                inputs[static_cast<size_t>(st * 2)][static_cast<size_t>(i)] = testSignal(t, freq, 0.5f);
+                inputs[static_cast<size_t>(st * 2 + 1)][static_cast<size_t>(i)] = testSignal(t, freq * 1.5f, 0.3f);
+            }
+        }
+
+        engine.process(blocks.data(), blockSize);
+
+        for (int st = 0; st < numStreams; ++st) {
+            const auto& block = blocks[static_cast<size_t>(st)];
+            references[static_cast<size_t>(st)].process(
+                block.inputL, block.inputR, &refPtrs[channelIndex(st, 0)], numOut, blockSize,
+                block.layout, block.dryWetTarget, block.gainDbTarget);
+
+            for (int ch = 0; ch < numOut; ++ch) {
+                for (int i = 0; i < blockSize; ++i) {
+                    ASSERT_EQ(engineOut[channelIndex(st, ch)][static_cast<size_t>(i)],
+                              refOut[channelIndex(st, ch)][static_cast<size_t>(i)])
+                        << "Stream " << st << " ch " << ch << " block " << b << " sample " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(UpmixEngineTest, WorkerPoolMatchesIndependentPipelines) {
+    verifyEngineMatchesPipelines(16, 3);
+}
+
+TEST(UpmixEngineTest, CallerOnlyMatchesIndependentPipelines) {
+    verifyEngineMatchesPipelines(4, 0);
+}
+
+TEST(UpmixEngineTest, MoreWorkersThanStreamsIsCapped) {
+    UpmixEngine engine;
+    engine.prepare(2, 48000.0, 64, SpeakerLayout::Stereo, 8);
+    EXPECT_EQ(engine.getNumStreams(), 2);
+    EXPECT_EQ(engine.getNumWorkers(), 1);
+}
+
+// ===== CPU load meter tests =====
+
+TEST(LoadMeterTest, LoadIsBlockTimeOverRealTimeBudget) {
+    LoadMeter meter;
+    meter.prepare(48000.0);
+
+    // 480 samples @ 48 kHz = 10 ms budget
+    meter.recordBlock(0.0025, 480);
+    auto snapshot = meter.getSnapshot();
+    EXPECT_NEAR(snapshot.currentLoad, 0.25f, 1e-6f);
+    EXPECT_NEAR(snapshot.peakLoad, 0.25f, 1e-6f);
+
+    meter.recordBlock(0.0061, 480);
+    meter.recordBlock(0.0010, 480);
+    snapshot = meter.getSnapshot();
+    EXPECT_NEAR(snapshot.currentLoad, 0.10f, 1e-6f);
+    EXPECT_NEAR(snapshot.peakLoad, 0.61f, 1e-6f);
+    EXPECT_EQ(snapshot.numBlocks, 3u);
+}
+
+TEST(LoadMeterTest, HistogramBinsAndMissedDeadlines) {
+    LoadMeter meter;
+    meter.prepare(48000.0);
+
+    meter.recordBlock(0.0005, 480);  // 5%   -> bin 0
+    meter.recordBlock(0.0055, 480);  // 55%  -> bin 5
+    meter.recordBlock(0.0058, 480);  // 58%  -> bin 5
+    meter.recordBlock(0.0100, 480);  // 100% -> overrun bin
+    meter.recordBlock(0.0300, 480);  // 300% -> overrun bin
+
+    auto snapshot = meter.getSnapshot();
+    EXPECT_EQ(snapshot.histogram[0], 1u);
+    EXPECT_EQ(snapshot.histogram[5], 2u);
+    EXPECT_EQ(snapshot.histogram[LoadMeter::kNumLoadBins - 1], 2u);
+
+    uint32_t total = 0;
+    for (auto count : snapshot.histogram)
+        total += count;
+    EXPECT_EQ(total, 5u);
+}
+
+TEST(LoadMeterTest, ResetIsAppliedOnNextBlock) {
+    LoadMeter meter;
+    meter.prepare(48000.0);
+    meter.recordBlock(0.0090, 480);
+    meter.recordBlock(0.0010, 480);
+
+    meter.requestReset();
+    meter.recordBlock(0.0020, 480);
+
+    auto snapshot = meter.getSnapshot();
+    EXPECT_NEAR(snapshot.peakLoad, 0.2f, 1e-6f);
+    EXPECT_EQ(snapshot.numBlocks, 1u);
+    EXPECT_EQ(snapshot.histogram[2], 1u);
+    EXPECT_EQ(snapshot.histogram[9], 0u);
+}
+
+// ===== Silence skip tests =====
+
+// Runs a 5.1 pipeline over the whole input in 256-sample blocks and returns
+// the 8 output channels (dry stereo + wet). Records isIdle() after each block.
+static std::vector<std::vector<float>> runPipeline(UpmixPipeline& pipeline,
+                                                   const std::vector<float>& inL,
+                                                   const std::vector<float>& inR,
+                                                   std::vector<bool>* idleAfterBlock = nullptr) {
+    constexpr int blockSize = 256;
+    constexpr int numOut = 8;
+    const int total = static_cast<int>(inL.size());
+
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(inL.size()));
+    for (int start = 0; start < total; start += blockSize) {
+        int n = std::min(blockSize, total - start);
+        float* ptrs[numOut];
+        for (int ch = 0; ch < numOut; ++ch)
+            ptrs[ch] = out[static_cast<size_t>(ch)].data() + start;
+        pipeline.process(inL.data() + start, inR.data() + start, ptrs, numOut, n,
+                         SpeakerLayout::Surround51, 1.0f, 0.0f);
+        if (idleAfterBlock != nullptr)
+            idleAfterBlock->push_back(pipeline.isIdle());
+    }
+    return out;
+}
+
+TEST(SilenceSkipTest, TailIsRenderedThenCutToExactZeros) {
+    UpmixPipeline pipeline;
+    pipeline.prepare(48000.0, 256, SpeakerLayout::Surround51);
+
+    const double tailSeconds = pipeline.getTailLengthSeconds();
+    EXPECT_GT(tailSeconds, 0.05);   // decorrelator loops ring for a while
+    EXPECT_LT(tailSeconds, 1.0);
+
+    // 0.5 s of signal, then 1.5 s of digital silence
+    constexpr int signalLength = 24000;
+    constexpr int totalLength = 96000;
+    std::vector<float> inL(totalLength, 0.0f);
+    std::vector<float> inR(totalLength, 0.0f);
+    for (int i = 0; i < signalLength; ++i) {
+        inL[static_cast<size_t>(i)] = testSignal(i, 220.0f, 0.5f) + testSignal(i, 3100.0f, 0.3f);
+        inR[static_cast<size_t>(i)] = testSignal(i, 330.0f, 0.5f) + testSignal(i, 5300.0f, 0.3f);
+    }
+
+    std::vector<bool> idle;
+    auto out = runPipeline(pipeline, inL, inR, &idle);
+
+    // Idle exactly from the first block that starts after the tail
+    const int tailSamples = static_cast<int>(std::lround(tailSeconds * 48000.0));
+    const int firstIdleBlock = (signalLength + tailSamples + 255) / 256;
+    for (size_t b = 0; b < idle.size(); ++b)
+        EXPECT_EQ(idle[b], static_cast<int>(b) >= firstIdleBlock) << "Block " << b;
+
+    // The wet tail is real: it keeps ringing well into the silence ...
+    float ringing = 0.0f;
+    for (int i = signalLength + 480; i < signalLength + 960; ++i)
+        for (int ch = 2; ch < 8; ++ch)
+            ringing = std::max(ringing, std::abs(out[static_cast<size_t>(ch)][static_cast<size_t>(i)]));
+    EXPECT_GT(ringing, 1e-3f);
+
+    // ... has decayed below the threshold just before the cut ...
+    const int cut = firstIdleBlock * 256;
+    float lastTail = 0.0f;
+    for (int i = cut - 256; i < cut; ++i)
+        for (int ch = 2; ch < 8; ++ch)
+            lastTail = std::max(lastTail, std::abs(out[static_cast<size_t>(ch)][static_cast<size_t>(i)]));
+    EXPECT_LT(lastTail, kTailThreshold);
+
+    // ... and is exact zeros afterwards
+    for (int ch = 0; ch < 8; ++ch)
+        for (int i = cut; i < totalLength; ++i)
+            ASSERT_EQ(std::abs(out[static_cast<size_t>(ch)][static_cast<size_t>(i)]), 0.0f)
+                << "Ch " << ch << " sample " << i;
+}
+
+TEST(SilenceSkipTest, ResumeAfterIdleMatchesFreshPipeline) {
+    // Once idle the DSP state is cleared, so resuming must be
+    // indistinguishable from starting a freshly prepared pipeline.
+    constexpr int silenceLength = 48000;
+    constexpr int resumeLength = 12000;
+
+    std::vector<float> resumeL(resumeLength);
+    std::vector<float> resumeR(resumeLength);
+    for (int i = 0; i < resumeLength; ++i) {
+        resumeL[static_cast<size_t>(i)] = testSignal(i, 440.0f, 0.5f);
+        resumeR[static_cast<size_t>(i)] = testSignal(i, 660.0f, 0.4f);
+    }
+
+    std::vector<float> inL(silenceLength, 0.0f);
+    std::vector<float> inR(silenceLength, 0.0f);
+    for (int i = 0; i < 4800; ++i) {
+        inL[static_cast<size_t>(i)] = testSignal(i, 1000.0f, 0.7f);
+        inR[static_cast<size_t>(i)] = testSignal(i, 150.0f, 0.7f);
+    }
+    inL.insert(inL.end(), resumeL.begin(), resumeL.end());
+    inR.insert(inR.end(), resumeR.begin(), resumeR.end());
+
+    UpmixPipeline pipeline;
+    pipeline.prepare(48000.0, 256, SpeakerLayout::Surround51);
+    auto out = runPipeline(pipeline, inL, inR);
+
+    UpmixPipeline fresh;
+    fresh.prepare(48000.0, 256, SpeakerLayout::Surround51);
+    auto ref = runPipeline(fresh, resumeL, resumeR);
+
+    for (int ch = 0; ch < 8; ++ch) {
+        for (int i = 0; i < resumeLength; ++i) {
+            ASSERT_EQ(out[static_cast<size_t>(ch)][static_cast<size_t>(silenceLength + i)],
+                      ref[static_cast<size_t>(ch)][static_cast<size_t>(i)])
+                << "Ch " << ch << " sample " << i;
+        }
+    }
+}
+
+TEST(SilenceSkipTest, QuietSignalIsNotSilence) {
+    // Only exact zeros count as silence; a -140 dBFS signal is processed.
+    constexpr int length = 96000;
+    std::vector<float> inL(length);
+    std::vector<float> inR(length);
+    for (int i = 0; i < length; ++i) {
+        inL[static_cast<size_t>(i)] = testSignal(i, 500.0f, 1e-7f);
+        inR[static_cast<size_t>(i)] = testSignal(i, 700.0f, 1e-7f);
+    }
+
+    UpmixPipeline pipeline;
+    pipeline.prepare(48000.0, 256, SpeakerLayout::Surround51);
+    std::vector<bool> idle;
+    auto out = runPipeline(pipeline, inL, inR, &idle);
+
+    for (bool blockIdle : idle)
+        EXPECT_FALSE(blockIdle);
+
+    float wetPeak = 0.0f;
+    for (int ch = 2; ch < 8; ++ch)
+        for (float v : out[static_cast<size_t>(ch)])
+            wetPeak = std::max(wetPeak, std::abs(v));
+    EXPECT_GT(wetPeak, 0.0f);
+}
+
+TEST(SilenceSkipTest, UnpreparedPipelineOutputsExactZeros) {
+    // A host may call process before prepare; the outputs must not keep
+    // whatever the buffers held.
+    std::vector<float> inL(256, 0.5f);
+    std::vector<float> inR(256, -0.5f);
+    std::vector<float> garbage(256, 1.0f);
+
+    UpmixPipeline pipeline;
+    std::vector<std::vector<float>> out(8, garbage);
+    float* ptrs[8];
+    for (size_t ch = 0; ch < 8; ++ch)
+        ptrs[ch] = out[ch].data();
+    pipeline.process(inL.data(), inR.data(), ptrs, 8, 256, SpeakerLayout::Surround51, 1.0f, 0.0f);
+
+    for (size_t ch = 0; ch < 8; ++ch)
+        for (float v : out[ch])
+            ASSERT_EQ(std::abs(v), 0.0f) << "Ch " << ch;
+}
+
+// ===== Output routing tests =====
+
+TEST(OutputRoutingTest, SparseAuxBusesCarryTheirOwnSpeakers) {
+    constexpr int blockSize = 256;
+    constexpr int numFull = 2 + 24;
+    // Aux pairs 1/2, 11/12 and 23/24 enabled: speakers 0-1, 10-11, 22-23
+    const int wetSpeakers[] = {0, 1, 10, 11, 22, 23};
+    constexpr int numSparse = 2 + 6;
+
+    UpmixPipeline full, sparse;
+    full.prepare(48000.0, blockSize, SpeakerLayout::Surround222);
+    sparse.prepare(48000.0, blockSize, SpeakerLayout::Surround222);
+    sparse.setOutputRouting(wetSpeakers, numSparse - 2);
+
+    std::vector<float> inL(blockSize), inR(blockSize);
+    std::vector<std::vector<float>> fullOut(numFull, std::vector<float>(blockSize));
+    std::vector<std::vector<float>> sparseOut(numSparse, std::vector<float>(blockSize));
+    float* fullPtrs[numFull];
+    float* sparsePtrs[numSparse];
+    for (int ch = 0; ch < numFull; ++ch) fullPtrs[ch] = fullOut[static_cast<size_t>(ch)].data();
+    for (int ch = 0; ch < numSparse; ++ch) sparsePtrs[ch] = sparseOut[static_cast<size_t>(ch)].data();
+
+    for (int block = 0; block < 20; ++block) {
+        // Switch layout halfway to cover the crossfade
+        auto layout = block < 10 ? SpeakerLayout::Surround222 : SpeakerLayout::Surround916;
+        for (int i = 0; i < blockSize; ++i) {
+            float t = static_cast<float>(block * blockSize + i) / 48000.0f;
+            inL[static_cast<size_t>(i)] = 0.5f * std::sin(2.0f * kPi * 220.0f * t);
+            inR[static_cast<size_t>(i)] = 0.4f * std::sin(2.0f * kPi * 330.0f * t);
+        }
+
+        full.process(inL.data(), inR.data(), fullPtrs, numFull, blockSize, layout, 1.0f, 0.0f);
+        sparse.process(inL.data(), inR.data(), sparsePtrs, numSparse, blockSize, layout, 1.0f, 0.0f);
+
+        for (int k = 0; k < numSparse - 2; ++k) {
+            const auto& expected = fullOut[static_cast<size_t>(2 + wetSpeakers[k])];
+            const auto& actual = sparseOut[static_cast<size_t>(2 + k)];
+            for (int i = 0; i < blockSize; ++i) {
+                ASSERT_FLOAT_EQ(actual[static_cast<size_t>(i)], expected[static_cast<size_t>(i)])
+                    << "Wet output " << k << " (speaker " << wetSpeakers[k] << ") block " << block
+                    << " sample " << i;
+            }
+        }
+    }
+}
+
+// ===== Velvet decorrelator tests =====
+
+TEST(VelvetDecorrelatorTest, ImpulseResponseIsSparseWithUnitEnergy) {
+    constexpr int numChannels = 4;
+    constexpr int taps = kVelvetTapsPerChannel[static_cast<int>(VelvetBudget::Medium)];
+    constexpr int blockSize = 256;
+    VelvetDecorrelatorBank bank;
+    bank.prepare(48000.0, blockSize, numChannels, taps);
+    ASSERT_EQ(bank.getTailSamples(), 960);
+
+    constexpr int numSamples = 1024;
+    std::vector<float> input(numSamples, 0.0f);
+    input[0] = 1.0f;
+    std::vector<std::vector<float>> out(numChannels, std::vector<float>(numSamples, 0.0f));
+    const float ones[numChannels] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    for (int start = 0; start < numSamples; start += blockSize) {
+        float* ptrs[numChannels];
+        for (int ch = 0; ch < numChannels; ++ch)
+            ptrs[ch] = out[static_cast<size_t>(ch)].data() + start;
+        bank.processBlock(input.data() + start, blockSize, ptrs, numChannels, ones, ones);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        int nonZero = 0;
+        float energy = 0.0f;
+        for (int i = 0; i < numSamples; ++i) {
+            float v = out[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+            if (std::abs(v) > 0.0f) {
+                ++nonZero;
+                EXPECT_LT(i, bank.getTailSamples()) << "Tap past the tail on channel " << ch;
+            }
+            energy += v * v;
+        }
+        EXPECT_EQ(nonZero, taps) << "Channel " << ch;
+        EXPECT_NEAR(energy, 1.0f, 1e-5f) << "Channel " << ch;
+    }
+}
+
+TEST(VelvetDecorrelatorTest, UnevenBlocksMatchDirectConvolution) {
+    // The input history is a ring; blocks of any size, including ones the
+    // bank splits, must wrap it seamlessly.
+    constexpr int numChannels = 2;
+    constexpr int maxBlockSize = 256;
+    constexpr int taps = kVelvetTapsPerChannel[static_cast<int>(VelvetBudget::Low)];
+    const float ones[numChannels] = {1.0f, 1.0f};
+
+    VelvetDecorrelatorBank bank;
+    bank.prepare(48000.0, maxBlockSize, numChannels, taps);
+    constexpr int irLength = 960;
+    ASSERT_EQ(bank.getTailSamples(), irLength);
+    std::vector<float> impulse(irLength, 0.0f);
+    impulse[0] = 1.0f;
+    std::vector<std::vector<float>> ir(numChannels, std::vector<float>(impulse.size(), 0.0f));
+    for (int start = 0; start < irLength; start += maxBlockSize) {
+        int n = std::min(maxBlockSize, irLength - start);
+        float* ptrs[numChannels] = {ir[0].data() + start, ir[1].data() + start};
+        bank.processBlock(impulse.data() + start, n, ptrs, numChannels, ones, ones);
+    }
+
+    constexpr int numSamples = 6000;
+    std::vector<float> input(numSamples);
+    uint32_t seed = 777;
+    for (auto& v : input) {
+        seed = seed * 1664525u + 1013904223u;
+        v = (static_cast<float>(seed) / static_cast<float>(UINT32_MAX)) * 2.0f - 1.0f;
+    }
+
+    bank.reset();
+    std::vector<std::vector<float>> out(numChannels, std::vector<float>(numSamples, 0.0f));
+    const int blockSizes[] = {1, 7, 64, 256, 300, 33, 500, 255};
+    for (int start = 0, b = 0; start < numSamples; ++b) {
+        int n = std::min(blockSizes[b % 8], numSamples - start);
+        float* ptrs[numChannels] = {out[0].data() + start, out[1].data() + start};
+        bank.processBlock(input.data() + start, n, ptrs, numChannels, ones, ones);
+        start += n;
+    }
+
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < numSamples; ++i) {
+            double expected = 0.0;
+            for (int d = 0; d <= std::min(i, irLength - 1); ++d)
+                expected += static_cast<double>(ir[ch][static_cast<size_t>(d)])
+                            * static_cast<double>(input[static_cast<size_t>(i - d)]);
+            ASSERT_NEAR(out[ch][static_cast<size_t>(i)], expected, 1e-5) << "Ch " << ch << " sample " << i;
+        }
+    }
+}
+
+TEST(VelvetDecorrelatorTest, ChannelsAreMutuallyDecorrelated) {
+    constexpr int numChannels = 8;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 100;
+    VelvetDecorrelatorBank bank;
+    bank.prepare(48000.0, blockSize, numChannels, kVelvetTapsPerChannel[static_cast<int>(VelvetBudget::Low)]);
+
+    uint32_t seed = 12345;
+    std::vector<float> input(blockSize);
+    std::vector<std::vector<float>> out(numChannels, std::vector<float>(blockSize * numBlocks, 0.0f));
+    float weights[numChannels];
+    std::fill(weights, weights + numChannels, 1.0f);
+
+    for (int block = 0; block < numBlocks; ++block) {
+        for (auto& v : input) {
+            seed = seed * 1664525u + 1013904223u;
+            v = (static_cast<float>(seed) / static_cast<float>(UINT32_MAX)) * 2.0f - 1.0f;
+        }
+        float* ptrs[numChannels];
+        for (int ch = 0; ch < numChannels; ++ch)
+            ptrs[ch] = out[static_cast<size_t>(ch)].data() + block * blockSize;
+        bank.processBlock(input.data(), blockSize, ptrs, numChannels, weights, weights);
+    }
+
+    for (int a = 0; a < numChannels; ++a) {
+        for (int b = a + 1; b < numChannels; ++b) {
+            double ab = 0.0, aa = 0.0, bb = 0.0;
+            for (size_t i = 0; i < out[0].size(); ++i) {
+                double va = out[static_cast<size_t>(a)][i];
+                double vb = out[static_cast<size_t>(b)][i];
+                ab += va * vb;
+                aa += va * va;
+                bb += vb * vb;
+            }
+            EXPECT_LT(std::abs(ab) / std::sqrt(aa * bb), 0.3)
+                << "Channels " << a << " and " << b << " are correlated";
+        }
+    }
+}
+
+TEST(VelvetDecorrelatorTest, PipelineKeepsSpeakerLevels) {
+    // Velvet diffuse is scaled to the level X/Z diffuse reaches per speaker
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 200;
+    const auto layout = SpeakerLayout::Surround714;
+    const int numOut = 2 + getLayoutInfo(layout).numChannels;
+
+    UpmixPipeline allpass, velvet;
+    allpass.prepare(48000.0, blockSize, layout);
+    velvet.prepare(48000.0, blockSize, layout, {}, VelvetBudget::High);
+
+    uint32_t seed = 777;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (static_cast<float>(seed) / static_cast<float>(UINT32_MAX)) * 2.0f - 1.0f;
+    };
+
+    std::vector<float> inL(blockSize), inR(blockSize);
+    std::vector<std::vector<float>> outA(static_cast<size_t>(numOut), std::vector<float>(blockSize));
+    std::vector<std::vector<float>> outV(static_cast<size_t>(numOut), std::vector<float>(blockSize));
+    std::vector<float*> ptrsA, ptrsV;
+    for (int ch = 0; ch < numOut; ++ch) {
+        ptrsA.push_back(outA[static_cast<size_t>(ch)].data());
+        ptrsV.push_back(outV[static_cast<size_t>(ch)].data());
+    }
+    std::vector<double> energyA(static_cast<size_t>(numOut), 0.0);
+    std::vector<double> energyV(static_cast<size_t>(numOut), 0.0);
+
+    for (int block = 0; block < numBlocks; ++block) {
+        // Partly correlated noise: some direct, mostly diffuse
+        for (int i = 0; i < blockSize; ++i) {
+            float common = nextRandom() * 0.2f;
+            inL[static_cast<size_t>(i)] = common + nextRandom() * 0.3f;
+            inR[static_cast<size_t>(i)] = common + nextRandom() * 0.3f;
+        }
+        allpass.process(inL.data(), inR.data(), ptrsA.data(), numOut, blockSize, layout, 1.0f, 0.0f);
+        velvet.process(inL.data(), inR.data(), ptrsV.data(), numOut, blockSize, layout, 1.0f, 0.0f);
+
+        if (block < 20)
+            continue;  // let the smoothers settle
+        for (int ch = 0; ch < numOut; ++ch) {
+            for (int i = 0; i < blockSize; ++i) {
+                double a = outA[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+                double v = outV[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+                energyA[static_cast<size_t>(ch)] += a * a;
+                energyV[static_cast<size_t>(ch)] += v * v;
+            }
+        }
+    }
+
+    for (int ch = 2; ch < numOut; ++ch) {
+        double dB = 10.0 * std::log10((energyV[static_cast<size_t>(ch)] + 1e-20)
+                                      / (energyA[static_cast<size_t>(ch)] + 1e-20));
+        EXPECT_NEAR(dB, 0.0, 1.5) << "Speaker " << ch - 2 << " level changed";
+    }
+}
+
+// ===== FastMath tests =====
+// The approximations must stay within their documented errors, and the hot
+// path (fast or std::, depending on UPMIXRT_FAST_MATH) within tolerance of a
+// std:: reference.
+
+TEST(FastMathTest, AtanAndAtan2WithinDocumentedError) {
+    float maxError = 0.0f;
+    for (int i = -1000; i <= 1000; ++i) {
+        float x = static_cast<float>(i) / 1000.0f;
+        maxError = std::max(maxError, std::abs(fast::atanUnit(x) - std::atan(x)));
+    }
+    for (int i = -60; i <= 60; ++i) {
+        for (int j = -60; j <= 60; ++j) {
+            float y = static_cast<float>(i) / 20.0f;
+            float x = static_cast<float>(j) / 20.0f;
+            maxError = std::max(maxError, std::abs(fast::atan2(y, x) - std::atan2(y, x)));
+        }
+    }
+    EXPECT_LE(maxError, kFastAtanMaxError);
+    EXPECT_NEAR(fast::atan2(0.0f, 0.0f), 0.0f, 1e-9f);
+}
+
+TEST(FastMathTest, Float8AtanMatchesScalar) {
+    alignas(32) float x[kNumBands] = {-1.0f, -0.7f, -0.41f, -0.1f, 0.0f, 0.3f, 0.5f, 1.0f};
+    alignas(32) float y[kNumBands];
+    fast::atanUnit(Float8::load(x)).store(y);
+    for (int i = 0; i < kNumBands; ++i)
+        EXPECT_NEAR(y[i], fast::atanUnit(x[i]), 1e-7f) << "lane " << i;
+}
+
+TEST(FastMathTest, CosWithinDocumentedError) {
+    float maxError = 0.0f;
+    for (int i = -2000; i <= 2000; ++i) {
+        float x = kPi * static_cast<float>(i) / 2000.0f;
+        maxError = std::max(maxError, std::abs(fast::cos(x) - std::cos(x)));
+    }
+    EXPECT_LE(maxError, kFastCosMaxError);
+}
+
+TEST(FastMathTest, SqrtIsExact) {
+    for (int i = 0; i <= 1000; ++i) {
+        float x = static_cast<float>(i) * 0.37f;
+        EXPECT_FLOAT_EQ(fast::sqrt(x), std::sqrt(x));
+    }
+    EXPECT_FLOAT_EQ(fast::sqrt(-1.0f), 0.0f);
+}
+
+TEST(FastMathTest, DbToGainWithinDocumentedError) {
+    float maxRelError = 0.0f;
+    for (int i = 0; i <= 14400; ++i) {
+        float db = -120.0f + static_cast<float>(i) * 0.01f;
+        double reference = std::pow(10.0, static_cast<double>(db) / 20.0);
+        double relError = std::abs(static_cast<double>(fast::dbToGain(db)) - reference) / reference;
+        maxRelError = std::max(maxRelError, static_cast<float>(relError));
+    }
+    EXPECT_LE(maxRelError, kFastDbToGainMaxRelError);
+    EXPECT_FLOAT_EQ(fast::dbToGain(0.0f), 1.0f);
+}
+
+TEST(FastMathTest, SpatialParamsWithinToleranceOfStdReference) {
+    // Reference: the band analysis and aggregation written out with std::
+    // math, fed by the scalar filter bank
+    FilterBank filterBank;
+    filterBank.prepare(48000.0);
+    HeightEstimator height;
+    height.prepare(48000.0);
+
+    auto alpha = [](float timeSec) { return 1.0f - std::exp(-1.0f / (48000.0f * timeSec)); };
+    const float iccAlpha = alpha(kICCSmoothingTimeSec);
+    const float azimuthAlpha = alpha(kAzimuthSmoothingTimeSec);
+    const float energyAlpha = alpha(kEnergySmoothingTimeSec);
+    float ll[kNumBands] = {}, rr[kNumBands] = {}, lr[kNumBands] = {};
+    float iccS[kNumBands] = {}, azS[kNumBands] = {}, energyS[kNumBands] = {};
+
+    SpatialAnalyzer analyzer;
+    analyzer.prepare(48000.0);
+
+    constexpr int numSamples = 9600;
+    std::vector<float> inL(numSamples), inR(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        float pan = 0.5f + 0.5f * testSignal(i, 3.0f, 1.0f);
+        inL[static_cast<size_t>(i)] = (1.0f - pan) * testSignal(i, 330.0f, 0.7f) + testSignal(i, 6000.0f, 0.1f);
+        inR[static_cast<size_t>(i)] = pan * testSignal(i, 330.0f, 0.7f) - testSignal(i, 1500.0f, 0.2f);
+    }
+
+    std::vector<SpatialParams> params(numSamples);
+    analyzer.processBlock(inL.data(), inR.data(), numSamples, params.data());
+
+    for (int i = 0; i < numSamples; ++i) {
+        float bandL[kNumBands], bandR[kNumBands];
+        filterBank.process(inL[static_cast<size_t>(i)], inR[static_cast<size_t>(i)], bandL, bandR);
+
+        float totalEnergy = kEpsilon, weightedICC = 0.0f, weightedAzimuth = 0.0f;
+        for (int b = 0; b < kNumBands; ++b) {
+            float l = bandL[b], r = bandR[b];
+            energyS[b] += energyAlpha * ((l * l + r * r) - energyS[b]);
+            ll[b] += iccAlpha * (l * l - ll[b]);
+            rr[b] += iccAlpha * (r * r - rr[b]);
+            lr[b] += iccAlpha * (l * r - lr[b]);
+            float denom = std::sqrt(ll[b] * rr[b]);
+            float icc = std::clamp(denom > kEpsilon ? lr[b] / denom : 0.0f, 0.0f, 1.0f);
+            iccS[b] += iccAlpha * (icc - iccS[b]);
+            float azSum = std::abs(r) + std::abs(l);
+            float azimuth = azSum > kEpsilon ? std::atan2(std::abs(r) - std::abs(l), azSum) * 2.0f : 0.0f;
+            azS[b] += azimuthAlpha * (azimuth - azS[b]);
+
+            totalEnergy += energyS[b];
+            weightedICC += energyS[b] * iccS[b];
+            weightedAzimuth += energyS[b] * azS[b];
+        }
+        float icc = weightedICC / totalEnergy;
+        float elevation = height.process(energyS);
+
+        const auto& p = params[static_cast<size_t>(i)];
+        ASSERT_NEAR(p.icc, icc, 1e-5f) << "sample " << i;
+        ASSERT_NEAR(p.azimuth, weightedAzimuth / totalEnergy, 1e-5f) << "sample " << i;
+        ASSERT_NEAR(p.diffuseness, std::sqrt(1.0f - std::clamp(icc, 0.0f, 1.0f)), 1e-4f) << "sample " << i;
+        ASSERT_NEAR(p.elevation, elevation, 1e-5f) << "sample " << i;
+    }
+}
+
+TEST(FastMathTest, OutputLevelsWithinToleranceOfStdReference) {
+    // Gain ramp 0 -> -42 dB through the writer's dB-domain smoother, which
+    // steps once per kGainRampLength segment
+    OutputWriter writer;
+    writer.prepare(48000.0);
+    const float gainAlpha = 1.0f - std::exp(-static_cast<float>(kGainRampLength) / (48000.0f * kGainSmoothTimeSec));
+
+    constexpr int numSamples = 4800;
+    constexpr int numOut = 3;
+    std::vector<float> wetIn(numSamples, 0.5f), dry(numSamples, 0.0f);
+    std::vector<std::vector<float>> out(numOut, std::vector<float>(numSamples));
+    float* outPtrs[numOut] = {out[0].data(), out[1].data(), out[2].data()};
+    const float* speakerPtrs[1] = {wetIn.data()};
+    writer.writeBlock(speakerPtrs, dry.data(), dry.data(), numSamples, 1.0f, -42.0f, numOut, outPtrs);
+
+    // Reference: the same segment ramp, with std::pow for the segment gains
+    float gainDb = 0.0f;
+    float rampStart = 1.0f;
+    float rampEnd = 1.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        int phase = i % kGainRampLength;
+        if (phase == 0) {
+            if (std::abs(-42.0f - gainDb) <= kGainSettleThresholdDb)
+                gainDb = -42.0f;
+            else
+                gainDb += gainAlpha * (-42.0f - gainDb);
+            rampStart = rampEnd;
+            rampEnd = std::pow(10.0f, gainDb / 20.0f);
+        }
+        float step = (rampEnd - rampStart) / static_cast<float>(kGainRampLength);
+        float expected = 0.5f * (rampStart + step * static_cast<float>(phase + 1));
+        ASSERT_NEAR(out[2][static_cast<size_t>(i)], expected, expected * 2e-6f) << "sample " << i;
+    }
+
+    // Encoder direct path: X = mid * sqrt(icc) * cos(azimuth) / 2 without diffuse feed
+    AmbisonicEncoder encoder;
+    encoder.prepare(48000.0);
+    for (int i = 0; i <= 100; ++i) {
+        float azimuth = -0.5f * kPi + kPi * static_cast<float>(i) / 100.0f;
+        float icc = static_cast<float>(i) / 100.0f;
+        float bFormat[4];
+        encoder.encode(0.8f, 0.4f, SpatialParams{icc, azimuth, 0.0f, 0.0f}, bFormat);
+        float expected = 0.6f * std::sqrt(icc) * std::cos(azimuth) * 0.5f;
+        ASSERT_NEAR(bFormat[BFormat::X], expected, 1e-6f) << "azimuth " << azimuth;
+    }
+}
+
+// ===== SIMD kernel dispatch tests =====
+
+// Every level built in and supported by this CPU, Scalar first
+static std::vector<SimdLevel> availableSimdLevels() {
+    std::vector<SimdLevel> levels;
+    for (int l = 0; l < kNumSimdLevels; ++l) {
+        if (isSimdLevelAvailable(static_cast<SimdLevel>(l)))
+            levels.push_back(static_cast<SimdLevel>(l));
+    }
+    return levels;
+}
+
+static bool bitIdentical(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+TEST(SimdDispatchTest, ScalarIsAlwaysAvailableAndCapsFallBack) {
+    EXPECT_TRUE(isSimdLevelAvailable(SimdLevel::Scalar));
+    EXPECT_EQ(getSimdKernels(SimdLevel::Scalar).level, SimdLevel::Scalar);
+
+    const SimdLevel best = getBestSimdLevel();
+    EXPECT_TRUE(isSimdLevelAvailable(best));
+    EXPECT_EQ(getSimdKernels().level, best);
+
+    // A cap picks the widest available level at or below it
+    for (int cap = 0; cap < kNumSimdLevels; ++cap) {
+        SimdLevel chosen = getSimdKernels(static_cast<SimdLevel>(cap)).level;
+        EXPECT_LE(static_cast<int>(chosen), cap);
+        EXPECT_TRUE(isSimdLevelAvailable(chosen));
+        for (int l = static_cast<int>(chosen) + 1; l <= cap; ++l)
+            EXPECT_FALSE(isSimdLevelAvailable(static_cast<SimdLevel>(l))) << getSimdLevelName(chosen);
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_TRUE(isSimdLevelAvailable(SimdLevel::SSE2));  // x86-64 baseline
+#endif
+}
+
+TEST(SimdDispatchTest, FilterBankLevelsMatchScalarBitForBit) {
+    constexpr int blockSize = 203;  // odd, to exercise the kernels' remainders
+    constexpr int numBlocks = 8;
+    const auto levels = availableSimdLevels();
+
+    for (int t = 0; t < 3; ++t) {
+        const auto topology = static_cast<FilterBankTopology>(t);
+        std::vector<std::vector<float>> reference;
+        for (SimdLevel level : levels) {
+            FilterBank bank, interleaved;
+            bank.prepare(48000.0, topology, getSimdKernels(level));
+            interleaved.prepare(48000.0, topology, getSimdKernels(level));
+
+            std::vector<float> inL(blockSize), inR(blockSize);
+            std::vector<std::vector<float>> bands(2 * kNumBands, std::vector<float>(blockSize));
+            std::vector<float> framesL(blockSize * kNumBands), framesR(blockSize * kNumBands);
+            float* bandL[kNumBands];
+            float* bandR[kNumBands];
+            for (int b = 0; b < kNumBands; ++b) {
+                bandL[b] = bands[static_cast<size_t>(b)].data();
+                bandR[b] = bands[static_cast<size_t>(kNumBands + b)].data();
+            }
+
+            // Blocks, then frames, of every band, end to end
+            std::vector<std::vector<float>> outputs(2 * kNumBands + 2);
+            for (int block = 0; block < numBlocks; ++block) {
+                for (int i = 0; i < blockSize; ++i) {
+                    int n = block * blockSize + i;
+                    inL[static_cast<size_t>(i)] = testSignal(n, 97.0f, 0.5f) + testSignal(n, 5100.0f, 0.2f);
+                    inR[static_cast<size_t>(i)] = testSignal(n, 410.0f, 0.4f) + testSignal(n, 12000.0f, 0.1f);
+                }
+                bank.processBlock(inL.data(), inR.data(), blockSize, bandL, bandR);
+                interleaved.processBlockInterleaved(inL.data(), inR.data(), blockSize,
+                                                    framesL.data(), framesR.data());
+                for (size_t b = 0; b < bands.size(); ++b)
+                    outputs[b].insert(outputs[b].end(), bands[b].begin(), bands[b].end());
+                outputs[2 * kNumBands].insert(outputs[2 * kNumBands].end(), framesL.begin(), framesL.end());
+                outputs[2 * kNumBands + 1].insert(outputs[2 * kNumBands + 1].end(), framesR.begin(),
+                                                  framesR.end());
+            }
+
+            if (level == SimdLevel::Scalar) {
+                reference = outputs;
+                continue;
+            }
+            for (size_t i = 0; i < outputs.size(); ++i)
+                EXPECT_TRUE(bitIdentical(outputs[i], reference[i]))
+                    << getSimdLevelName(level) << " topology " << t << " output " << i;
+        }
+    }
+}
+
+TEST(SimdDispatchTest, DecoderLevelsMatchScalarBitForBit) {
+    constexpr int blockSize = 77;
+    const auto levels = availableSimdLevels();
+
+    std::vector<std::vector<float>> bFormat(kNumAmbiChannels, std::vector<float>(blockSize));
+    const float* bFormatPtrs[kNumAmbiChannels];
+    for (int ch = 0; ch < kNumAmbiChannels; ++ch) {
+        bFormatPtrs[ch] = bFormat[static_cast<size_t>(ch)].data();
+        for (int i = 0; i < blockSize; ++i)
+            bFormat[static_cast<size_t>(ch)][static_cast<size_t>(i)] =
+                testSignal(i, 110.0f * static_cast<float>(ch + 1), 0.5f);
+    }
+    std::vector<float> gain(blockSize);
+    for (int i = 0; i < blockSize; ++i)
+        gain[static_cast<size_t>(i)] = 0.25f + 0.01f * static_cast<float>(i);
+
+    for (int l = 0; l < static_cast<int>(SpeakerLayout::kNumLayouts); ++l) {
+        const auto layout = static_cast<SpeakerLayout>(l);
+        std::vector<float> reference;
+        for (SimdLevel level : levels) {
+            AmbisonicDecoder decoder;
+            decoder.prepare(48000.0, layout, getSimdKernels(level));
+
+            // Block feeds without and with a gain ramp, then frame by frame
+            std::vector<std::vector<float>> speakers(kMaxOutputChannels, std::vector<float>(blockSize));
+            float* speakerPtrs[kMaxOutputChannels];
+            for (int ch = 0; ch < kMaxOutputChannels; ++ch)
+                speakerPtrs[ch] = speakers[static_cast<size_t>(ch)].data();
+            std::vector<float> outputs;
+            const float* wetGains[] = {nullptr, gain.data()};
+            for (const float* wetGain : wetGains) {
+                decoder.decodeBlock(bFormatPtrs, blockSize, layout, speakerPtrs, kMaxOutputChannels,
+                                    wetGain);
+                for (const auto& feed : speakers)
+                    outputs.insert(outputs.end(), feed.begin(), feed.end());
+            }
+            for (int i = 0; i < blockSize; ++i) {
+                float frame[kNumAmbiChannels];
+                float feeds[kMaxOutputChannels];
+                for (int ch = 0; ch < kNumAmbiChannels; ++ch)
+                    frame[ch] = bFormat[static_cast<size_t>(ch)][static_cast<size_t>(i)];
+                decoder.decode(frame, layout, feeds);
+                outputs.insert(outputs.end(), feeds, feeds + kMaxOutputChannels);
+            }
+
+            if (level == SimdLevel::Scalar)
+                reference = outputs;
+            else
+                EXPECT_TRUE(bitIdentical(outputs, reference))
+                    << getSimdLevelName(level) << " " << getLayoutInfo(layout).name;
+        }
+    }
+}
+
+TEST(SimdDispatchTest, AnalysisAzimuthWithinFastAtanBound) {
+    // Every level takes the band azimuth from the polynomial atan, with
+    // UPMIXRT_FAST_MATH on or off
+    constexpr int numFrames = 64;
+    for (SimdLevel level : availableSimdLevels()) {
+        const SimdKernels& kernels = getSimdKernels(level);
+        for (int s = 0; s < numFrames; ++s) {
+            alignas(32) float bandL[kNumBands];
+            alignas(32) float bandR[kNumBands];
+            for (int b = 0; b < kNumBands; ++b) {
+                bandL[b] = testSignal(s, 310.0f * static_cast<float>(b + 1), 0.5f);
+                bandR[b] = (b == 3) ? 0.0f : testSignal(s + 7, 170.0f * static_cast<float>(b + 2), 0.4f);
+            }
+            bandL[5] = 0.0f;  // silence in one band
+            bandR[5] = 0.0f;
+
+            // alpha 1: the smoothed azimuth is the raw one of this frame
+            AnalysisBankState state;
+            state.azimuthAlpha = 1.0f;
+            float icc = 0.0f, azimuth = 0.0f;
+            float energies[kNumBands];
+            kernels.analysisProcessBlock(state, bandL, bandR, 1, &icc, &azimuth, energies);
+
+            for (int b = 0; b < kNumBands; ++b) {
+                float absL = std::abs(bandL[b]);
+                float absR = std::abs(bandR[b]);
+                float sum = absR + absL;
+                float expected = (sum > kEpsilon) ? std::atan2(absR - absL, sum) * 2.0f : 0.0f;
+                ASSERT_NEAR(state.azimuthSmooth[b], expected, 2.0f * kFastAtanMaxError)
+                    << getSimdLevelName(level) << " frame " << s << " band " << b;
+            }
+        }
+    }
+}
+
+TEST(SimdDispatchTest, PipelineLevelsMatchScalarBitForBit) {
+    // Covers the band analysis (both modes) and the output gain ramps too
+    constexpr int blockSize = 250;
+    constexpr int numBlocks = 40;
+    constexpr int numOut = 2 + 24;
+    const auto levels = availableSimdLevels();
+
+    for (int controlInterval : {1, 16}) {
+        for (int t = 0; t < 3; ++t) {
+            AnalysisConfig config;
+            config.controlInterval = controlInterval;
+            config.filterBankTopology = static_cast<FilterBankTopology>(t);
+
+            std::vector<float> reference;
+            for (SimdLevel level : levels) {
+                UpmixPipeline pipeline;
+                pipeline.prepare(48000.0, blockSize, SpeakerLayout::Surround222, config,
+                                 VelvetBudget::Off, level);
+                ASSERT_EQ(pipeline.getSimdLevel(), level);
+
+                std::vector<float> inL(blockSize), inR(blockSize);
+                std::vector<std::vector<float>> out(numOut, std::vector<float>(blockSize));
+                float* outPtrs[numOut];
+                for (int ch = 0; ch < numOut; ++ch) outPtrs[ch] = out[static_cast<size_t>(ch)].data();
+
+                std::vector<float> outputs;
+                for (int block = 0; block < numBlocks; ++block) {
+                    float dryWet = block < 20 ? 1.0f : 0.7f;
+                    float gainDb = block < 25 ? 0.0f : -9.0f;
+                    auto layout = block < 30 ? SpeakerLayout::Surround222 : SpeakerLayout::Surround714;
+                    for (int i = 0; i < blockSize; ++i) {
+                        int n = block * blockSize + i;
+                        inL[static_cast<size_t>(i)] = testSignal(n, 220.0f, 0.5f) + testSignal(n, 7000.0f, 0.1f);
+                        inR[static_cast<size_t>(i)] = testSignal(n, 330.0f, 0.4f);
+                    }
+                    pipeline.process(inL.data(), inR.data(), outPtrs, numOut, blockSize, layout,
+                                     dryWet, gainDb);
+                    for (const auto& channel : out)
+                        outputs.insert(outputs.end(), channel.begin(), channel.end());
+                }
+
+                if (level == SimdLevel::Scalar)
+                    reference = outputs;
+                else
+                    EXPECT_TRUE(bitIdentical(outputs, reference))
+                        << getSimdLevelName(level) << " interval " << controlInterval << " topology " << t;
+            }
+        }
+    }
+}
+
+// ===== Multirate analysis tests =====
+// The half-band stages must keep their documented response, and multirate
+// analysis must stay within its bounds of the full-rate per-sample path.
+
+// RMS gain of decimator on a sine at freq (fraction of the input rate)
+static float halfBandGain(HalfBandDesign design, double freq) {
+    HalfBandDecimator decimator;
+    decimator.prepare(design);
+
+    constexpr int blockSize = 64;
+    constexpr int numBlocks = 64;
+    constexpr int settleOutputs = 64;
+    double inputPower = 0.0, outputPower = 0.0;
+    int numOutputs = 0;
+    float inL[blockSize], inR[blockSize], outL[blockSize], outR[blockSize];
+    for (int b = 0; b < numBlocks; ++b) {
+        for (int s = 0; s < blockSize; ++s) {
+            inL[s] = testSignal(b * blockSize + s, static_cast<float>(freq), 0.5f, 1.0f);
+            inR[s] = -inL[s];
+        }
+        int n = decimator.processBlock(inL, inR, blockSize, outL, outR);
+        for (int s = 0; s < n; ++s, ++numOutputs) {
+            EXPECT_FLOAT_EQ(outR[s], -outL[s]);
+            if (numOutputs < settleOutputs) continue;
+            inputPower += 0.125;
+            outputPower += static_cast<double>(outL[s]) * static_cast<double>(outL[s]);
+        }
+    }
+    return static_cast<float>(std::sqrt(outputPower / inputPower));
+}
+
+TEST(HalfBandDecimatorTest, PassbandIsFlatAndStopbandAttenuated) {
+    struct Band {
+        HalfBandDesign design;
+        double passEdge;
+        double stopEdge;
+    };
+    for (const Band& band : {Band{HalfBandDesign::Sharp, 0.2, 0.3}, Band{HalfBandDesign::Wide, 0.125, 0.375}}) {
+        for (double freq : {0.01, band.passEdge / 2.0, band.passEdge}) {
+            float gainDb = 20.0f * std::log10(halfBandGain(band.design, freq));
+            EXPECT_NEAR(gainDb, 0.0f, 0.05f) << "passband " << freq;
+        }
+        for (double freq : {band.stopEdge, (band.stopEdge + 0.5) / 2.0, 0.49}) {
+            float gainDb = 20.0f * std::log10(halfBandGain(band.design, freq));
+            EXPECT_LT(gainDb, -50.0f) << "stopband " << freq;
+        }
+    }
+}
+
+TEST(HalfBandDecimatorTest, ChunkedBlocksMatchOneShot) {
+    for (HalfBandDesign design : {HalfBandDesign::Sharp, HalfBandDesign::Wide}) {
+        HalfBandDecimator oneShot, chunked;
+        oneShot.prepare(design);
+        chunked.prepare(design);
+
+        constexpr int numSamples = 4 * kSubBlockSize;
+        std::vector<float> inL(numSamples), inR(numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            inL[static_cast<size_t>(i)] = testSignal(i, 1000.0f, 0.5f);
+            inR[static_cast<size_t>(i)] = testSignal(i, 3100.0f, 0.3f);
+        }
+        std::vector<float> refL(numSamples), refR(numSamples);
+        int refOutputs = 0;
+        for (int pos = 0; pos < numSamples; pos += kSubBlockSize) {
+            refOutputs += oneShot.processBlock(inL.data() + pos, inR.data() + pos, kSubBlockSize,
+                                               refL.data() + refOutputs, refR.data() + refOutputs);
+        }
+        EXPECT_EQ(refOutputs, numSamples / 2);
+
+        // Odd sizes, a single sample and an empty block, then full ones; in place
+        std::vector<float> bufL = inL, bufR = inR;
+        std::vector<float> outL, outR;
+        std::vector<int> sizes = {1, 0, 3, 7, 2, 13, 1, 1, kSubBlockSize, 5, kSubBlockSize - 1};
+        int pos = 0;
+        for (int size : sizes)
+            pos += size;
+        for (; pos < numSamples; pos += kSubBlockSize)
+            sizes.push_back(std::min(kSubBlockSize, numSamples - pos));
+        pos = 0;
+        for (int size : sizes) {
+            int n = chunked.processBlock(bufL.data() + pos, bufR.data() + pos, size,
+                                         bufL.data() + pos, bufR.data() + pos);
+            EXPECT_EQ(n, (pos + size) / 2 - pos / 2) << "block at " << pos;
+            outL.insert(outL.end(), bufL.begin() + pos, bufL.begin() + pos + n);
+            outR.insert(outR.end(), bufR.begin() + pos, bufR.begin() + pos + n);
+            pos += size;
+        }
+
+        ASSERT_EQ(static_cast<int>(outL.size()), refOutputs);
+        for (int i = 0; i < refOutputs; ++i) {
+            EXPECT_FLOAT_EQ(outL[static_cast<size_t>(i)], refL[static_cast<size_t>(i)]) << "output " << i;
+            EXPECT_FLOAT_EQ(outR[static_cast<size_t>(i)], refR[static_cast<size_t>(i)]) << "output " << i;
+        }
+    }
+}
+
+TEST(MultirateTest, PanSweepWithinBoundsAt48k) {
+    verifyAnalysisBounds(makeAnalysisConfig(1, true), 48000.0, true);
+    verifyAnalysisBounds(makeAnalysisConfig(32, true), 48000.0, true);
+}
+
+TEST(MultirateTest, UncorrelatedNoiseWithinBoundsAt48k) {
+    verifyAnalysisBounds(makeAnalysisConfig(1, true), 48000.0, false);
+    verifyAnalysisBounds(makeAnalysisConfig(32, true), 48000.0, false);
+}
+
+TEST(MultirateTest, WithinBoundsAt96k) {
+    verifyAnalysisBounds(makeAnalysisConfig(32, true), 96000.0, true);
+    verifyAnalysisBounds(makeAnalysisConfig(32, true), 96000.0, false);
+}
+
+TEST(MultirateTest, WithinBoundsAt192k) {
+    verifyAnalysisBounds(makeAnalysisConfig(1, true), 192000.0, true);
+    verifyAnalysisBounds(makeAnalysisConfig(32, true), 192000.0, false);
+}
+
+// ===== STFT analysis tests =====
+// The STFT engine must produce the same SpatialParams contract as the
+// filter bank, lagging by its reported latency, at a cost flat in the
+// number of bands; the pipeline delays the audio to match.
+
+TEST(StereoFftTest, MatchesDirectDft) {
+    for (int size : {4, 8, 64, 512}) {
+        StereoFft fft;
+        fft.prepare(size);
+        ASSERT_EQ(fft.getSize(), size);
+
+        const size_t numBins = static_cast<size_t>(size / 2 + 1);
+        std::vector<float> inL(static_cast<size_t>(size)), inR(static_cast<size_t>(size));
+        for (int n = 0; n < size; ++n) {
+            inL[static_cast<size_t>(n)] = std::sin(0.3f * static_cast<float>(n)) + 0.2f;
+            inR[static_cast<size_t>(n)] = std::cos(1.7f * static_cast<float>(n * n) / static_cast<float>(size));
+        }
+        std::vector<float> realL(numBins), imagL(numBins), realR(numBins), imagR(numBins);
+        fft.transform(inL.data(), inR.data(), realL.data(), imagL.data(), realR.data(), imagR.data());
+
+        for (size_t k = 0; k < numBins; ++k) {
+            std::complex<double> refL, refR;
+            for (int n = 0; n < size; ++n) {
+                auto w = std::polar(1.0, -2.0 * 3.14159265358979323846 * static_cast<double>(k) * n / size);
+                refL += w * static_cast<double>(inL[static_cast<size_t>(n)]);
+                refR += w * static_cast<double>(inR[static_cast<size_t>(n)]);
+            }
+            double tolerance = 1e-5 * size;
+            EXPECT_NEAR(realL[k], refL.real(), tolerance) << "size " << size << " bin " << k;
+            EXPECT_NEAR(imagL[k], refL.imag(), tolerance) << "size " << size << " bin " << k;
+            EXPECT_NEAR(realR[k], refR.real(), tolerance) << "size " << size << " bin " << k;
+            EXPECT_NEAR(imagR[k], refR.imag(), tolerance) << "size " << size << " bin " << k;
+        }
+    }
+}
+
+TEST(StftAnalyzerTest, FrameSizesAndLatency) {
+    struct Expected {
+        double sampleRate;
+        int fftSize;
+    };
+    for (const Expected& e : {Expected{44100.0, 1024}, Expected{48000.0, 1024},
+                              Expected{96000.0, 2048}, Expected{192000.0, 4096}}) {
+        StftAnalyzer stft;
+        stft.prepare(e.sampleRate);
+        EXPECT_EQ(stft.getFftSize(), e.fftSize);
+        EXPECT_EQ(stft.getHopSize(), e.fftSize / kStftHopDivisor);
+        EXPECT_EQ(stft.getLatencySamples(), e.fftSize / 2 + e.fftSize / kStftHopDivisor);
+    }
+
+    SpatialAnalyzer filterBank, stft;
+    filterBank.prepare(48000.0);
+    AnalysisConfig config;
+    config.engine = AnalysisEngine::Stft;
+    stft.prepare(48000.0, config);
+    EXPECT_EQ(filterBank.getLatencySamples(), 0);
+    EXPECT_EQ(stft.getLatencySamples(), 768);
+}
+
+TEST(StftAnalyzerTest, BandsPartitionTheBins) {
+    for (BandScale scale : {BandScale::Bark, BandScale::Erb}) {
+        for (int numBands : {1, 8, 24, 32, kStftMaxBands, kStftMaxBands + 10}) {
+            StftAnalyzer stft;
+            stft.prepare(48000.0, numBands, scale);
+            ASSERT_EQ(stft.getNumBands(), std::min(numBands, kStftMaxBands));
+
+            const int numBins = stft.getFftSize() / 2 + 1;
+            EXPECT_EQ(stft.getBandStartBin(0), 0);
+            EXPECT_EQ(stft.getBandStartBin(stft.getNumBands()), numBins);
+            int nonEmpty = 0;
+            for (int b = 0; b < stft.getNumBands(); ++b) {
+                EXPECT_LE(stft.getBandStartBin(b), stft.getBandStartBin(b + 1));
+                if (stft.getBandStartBin(b + 1) > stft.getBandStartBin(b))
+                    ++nonEmpty;
+            }
+            // Only the narrowest low bands can fall between bins
+            EXPECT_GE(nonEmpty, stft.getNumBands() * 3 / 4) << numBands << " bands";
+        }
+    }
+
+    // Perceptual spacing: the top band is far wider than the bottom one
+    StftAnalyzer stft;
+    stft.prepare(48000.0, 24, BandScale::Bark);
+    int bottom = stft.getBandStartBin(2) - stft.getBandStartBin(1);
+    int top = stft.getBandStartBin(23) - stft.getBandStartBin(22);
+    EXPECT_GT(top, 10 * bottom);
+}
+
+// STFT SpatialParams over numSamples of the given signal, with the
+// filter-bank reference shifted by the STFT latency
+static void runStftAndReference(double sampleRate, const std::vector<float>& inL,
+                                const std::vector<float>& inR, int numBands, BandScale scale,
+                                std::vector<SpatialParams>& stftParams,
+                                std::vector<SpatialParams>& referenceParams, int& latency) {
+    AnalysisConfig config;
+    config.engine = AnalysisEngine::Stft;
+    config.stftNumBands = numBands;
+    config.stftBandScale = scale;
+    SpatialAnalyzer stft, reference;
+    stft.prepare(sampleRate, config);
+    reference.prepare(sampleRate);
+    latency = stft.getLatencySamples();
+
+    stftParams.resize(inL.size());
+    referenceParams.resize(inL.size());
+    stft.processBlock(inL.data(), inR.data(), static_cast<int>(inL.size()), stftParams.data());
+    reference.processBlock(inL.data(), inR.data(), static_cast<int>(inL.size()), referenceParams.data());
+}
+
+TEST(StftAnalyzerTest, TracksPanSweepLikeFilterBank) {
+    for (double sampleRate : {48000.0, 192000.0}) {
+        for (BandScale scale : {BandScale::Bark, BandScale::Erb}) {
+            const int numSamples = static_cast<int>(sampleRate);
+            std::vector<float> inL(static_cast<size_t>(numSamples)), inR(static_cast<size_t>(numSamples));
+            uint32_t seed = 12345;
+            for (int i = 0; i < numSamples; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                float a = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+                float pan = 0.5f + 0.4f * testSignal(i, 1.0f, 1.0f, static_cast<float>(sampleRate));
+                inL[static_cast<size_t>(i)] = a * (1.0f - pan);
+                inR[static_cast<size_t>(i)] = a * pan;
+            }
+
+            std::vector<SpatialParams> stft, reference;
+            int latency = 0;
+            runStftAndReference(sampleRate, inL, inR, 32, scale, stft, reference, latency);
+
+            // Coherent source: ICC near 1, and the azimuth of the filter bank
+            // once the latency is taken out
+            float maxICC = 0.0f, maxAzimuth = 0.0f, maxElevation = 0.0f;
+            for (int i = numSamples / 10; i < numSamples; ++i) {
+                const auto& p = stft[static_cast<size_t>(i)];
+                const auto& ref = reference[static_cast<size_t>(i - latency)];
+                maxICC = std::max(maxICC, std::abs(p.icc - ref.icc));
+                maxAzimuth = std::max(maxAzimuth, std::abs(p.azimuth - ref.azimuth));
+                maxElevation = std::max(maxElevation, std::abs(p.elevation - ref.elevation));
+                ASSERT_GE(p.icc, 0.0f);
+                ASSERT_LE(p.icc, 1.0f);
+                ASSERT_GE(p.diffuseness, 0.0f);
+                ASSERT_LE(p.diffuseness, 1.0f);
+                ASSERT_GE(p.elevation, 0.0f);
+                ASSERT_LE(p.elevation, kHeightMaxElevation);
+            }
+            EXPECT_LT(maxICC, 0.02f) << sampleRate;
+            EXPECT_LT(maxAzimuth, 0.05f) << sampleRate;
+            EXPECT_LT(maxElevation, 0.05f) << sampleRate;
+        }
+    }
+}
+
+TEST(StftAnalyzerTest, UncorrelatedNoiseHasLowICC) {
+    constexpr int numSamples = 48000;
+    std::vector<float> inL(numSamples), inR(numSamples);
+    uint32_t seed = 777;
+    auto noise = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+    };
+    for (int i = 0; i < numSamples; ++i) {
+        inL[static_cast<size_t>(i)] = noise();
+        inR[static_cast<size_t>(i)] = noise();
+    }
+
+    for (int numBands : {8, 24, 64}) {
+        std::vector<SpatialParams> stft, reference;
+        int latency = 0;
+        runStftAndReference(48000.0, inL, inR, numBands, BandScale::Bark, stft, reference, latency);
+
+        double meanICC = 0.0, meanAzimuth = 0.0;
+        for (int i = numSamples / 10; i < numSamples; ++i) {
+            meanICC += static_cast<double>(stft[static_cast<size_t>(i)].icc);
+            meanAzimuth += static_cast<double>(stft[static_cast<size_t>(i)].azimuth);
+        }
+        meanICC /= numSamples - numSamples / 10;
+        meanAzimuth /= numSamples - numSamples / 10;
+        EXPECT_LT(meanICC, 0.15) << numBands << " bands";
+        EXPECT_NEAR(meanAzimuth, 0.0, 0.05) << numBands << " bands";
+    }
+}
+
+TEST(StftAnalyzerTest, PipelineDelaysAudioByLatency) {
+    AnalysisConfig config;
+    config.engine = AnalysisEngine::Stft;
+
+    constexpr int numSamples = 6000;
+    std::vector<float> inL(numSamples), inR(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        inL[static_cast<size_t>(i)] = testSignal(i, 220.0f, 0.5f);
+        inR[static_cast<size_t>(i)] = testSignal(i, 3300.0f, 0.3f);
+    }
+
+    UpmixPipeline filterBank;
+    filterBank.prepare(48000.0, 512, SpeakerLayout::Surround51);
+    EXPECT_EQ(filterBank.getLatencySamples(), 0);
+
+    // Blocks shorter and longer than the delay
+    for (int blockSize : {100, 1000}) {
+        UpmixPipeline pipeline;
+        pipeline.prepare(48000.0, blockSize, SpeakerLayout::Surround51, config);
+        const int latency = pipeline.getLatencySamples();
+        ASSERT_EQ(latency, 768);
+
+        constexpr int numOut = 8;
+        std::vector<std::vector<float>> out(numOut, std::vector<float>(numSamples));
+        for (int start = 0; start < numSamples; start += blockSize) {
+            int n = std::min(blockSize, numSamples - start);
+            float* ptrs[numOut];
+            for (int ch = 0; ch < numOut; ++ch)
+                ptrs[ch] = out[static_cast<size_t>(ch)].data() + start;
+            pipeline.process(inL.data() + start, inR.data() + start, ptrs, numOut, n,
+                             SpeakerLayout::Surround51, 1.0f, 0.0f);
+        }
+
+        // The dry path is the input, latency samples later; the wet
+        // outputs start no earlier
+        for (int i = 0; i < numSamples; ++i) {
+            float expectedL = i < latency ? 0.0f : inL[static_cast<size_t>(i - latency)];
+            float expectedR = i < latency ? 0.0f : inR[static_cast<size_t>(i - latency)];
+            ASSERT_EQ(out[0][static_cast<size_t>(i)], expectedL) << "block " << blockSize << " sample " << i;
+            ASSERT_EQ(out[1][static_cast<size_t>(i)], expectedR) << "block " << blockSize << " sample " << i;
+        }
+        for (int ch = 2; ch < numOut; ++ch)
+            for (int i = 0; i < latency; ++i)
+                ASSERT_EQ(out[static_cast<size_t>(ch)][static_cast<size_t>(i)], 0.0f) << "ch " << ch;
+        float wetPeak = 0.0f;
+        for (int i = latency; i < numSamples; ++i)
+            wetPeak = std::max(wetPeak, std::abs(out[2][static_cast<size_t>(i)]));
+        EXPECT_GT(wetPeak, 0.1f);
+    }
 }
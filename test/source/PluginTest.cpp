@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <UpmixRT/PluginProcessor.h>
+#include <UpmixRT/SpeakerLayout.h>
+
+using namespace audio_plugin;
+
+// ===== Plugin instantiation test =====
+
+TEST(PluginTest, CanInstantiate) {
+    auto plugin = std::make_unique<AudioPluginAudioProcessor>();
+    EXPECT_NE(plugin, nullptr);
+    EXPECT_EQ(plugin->getName(), "UpmixRT");
+}
+
+// ===== Discrete wet bus tests =====
+
+struct DiscreteWetLayout {
+    SpeakerLayout layout;
+    juce::AudioChannelSet channelSet;
+};
+
+// Each multichannel layout in the host's own channel set. JUCE has no named
+// 22.2 set, so that one lists the 24 speakers of ITU-R BS.2051 system H.
+static std::vector<DiscreteWetLayout> discreteWetLayouts() {
+    using Set = juce::AudioChannelSet;
+    const auto surround222 = Set::channelSetWithChannels({
+        Set::left, Set::right, Set::centre, Set::LFE, Set::leftCentre, Set::rightCentre,
+        Set::centreSurround, Set::leftSurroundSide, Set::rightSurroundSide, Set::topMiddle,
+        Set::topFrontLeft, Set::topFrontCentre, Set::topFrontRight, Set::topRearLeft,
+        Set::topRearCentre, Set::topRearRight, Set::LFE2, Set::leftSurroundRear,
+        Set::rightSurroundRear, Set::topSideLeft, Set::topSideRight, Set::bottomFrontLeft,
+        Set::bottomFrontCentre, Set::bottomFrontRight });
+    return {
+        {SpeakerLayout::Surround51, Set::create5point1()},
+        {SpeakerLayout::Surround714, Set::create7point1point4()},
+        {SpeakerLayout::Surround916, Set::create9point1point6()},
+        {SpeakerLayout::Surround222, surround222},
+        {SpeakerLayout::AmbiX, Set::ambisonic(1)},
+    };
+}
+
+// Decoder speaker index of channel type `type` in `layout`, for the types
+// whose position is pinned down here; -1 for the others
+static int expectedSpeaker(SpeakerLayout layout, juce::AudioChannelSet::ChannelType type) {
+    using Set = juce::AudioChannelSet;
+    if (layout == SpeakerLayout::AmbiX) {
+        // ACN k is ambisonic channel k
+        if (type >= Set::ambisonicACN0 && type <= Set::ambisonicACN3)
+            return type - Set::ambisonicACN0;
+        return -1;
+    }
+    if (type == Set::left) return 0;
+    if (type == Set::right) return 1;
+    if (type == Set::centre) return 2;
+    if (type == Set::LFE) return getLayoutInfo(layout).lfeChannelIndex;
+    if (type == Set::topFrontLeft
+        && (layout == SpeakerLayout::Surround714 || layout == SpeakerLayout::Surround916))
+        return 8;
+    if (type == Set::wideLeft && layout == SpeakerLayout::Surround916) return 14;
+    if (type == Set::LFE2 && layout == SpeakerLayout::Surround222) return 9;
+    return -1;
+}
+
+// Stereo in, stereo main out, `wetSet` on the first aux bus, the other aux
+// buses disabled
+static juce::AudioProcessor::BusesLayout discreteWetBusesLayout(
+    const AudioPluginAudioProcessor& plugin, const juce::AudioChannelSet& wetSet) {
+    auto layouts = plugin.getBusesLayout();
+    for (int i = 1; i < layouts.outputBuses.size(); ++i)
+        layouts.outputBuses.getReference(i) = juce::AudioChannelSet::disabled();
+    layouts.outputBuses.getReference(1) = wetSet;
+    return layouts;
+}
+
+// Runs one block of noise through `plugin` (its buses already set to a
+// discrete `layout` wet bus) and compares each wet channel with the speaker
+// feeds of a stand-alone pipeline in decoder order. Every channel must carry
+// a feed of its own, and the channel types of expectedSpeaker() exactly
+// that speaker.
+static void expectWetChannelsCarryTheirSpeakers(AudioPluginAudioProcessor& plugin,
+                                                SpeakerLayout layout) {
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 512;
+
+    const int numSpeakers = getLayoutInfo(layout).numChannels;
+    const auto wetSet = plugin.getBus(false, 1)->getCurrentLayout();
+    ASSERT_EQ(wetSet.size(), numSpeakers);
+    const int numOutputChannels = plugin.getTotalNumOutputChannels();
+    ASSERT_EQ(numOutputChannels, 2 + numSpeakers);
+
+    juce::Random random(1);
+    std::vector<float> inputL(kBlockSize), inputR(kBlockSize);
+    for (int i = 0; i < kBlockSize; ++i) {
+        inputL[static_cast<size_t>(i)] = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+        inputR[static_cast<size_t>(i)] = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    plugin.prepareToPlay(kSampleRate, kBlockSize);
+    juce::AudioBuffer<float> buffer(numOutputChannels, kBlockSize);
+    buffer.clear();
+    buffer.copyFrom(0, 0, inputL.data(), kBlockSize);
+    buffer.copyFrom(1, 0, inputR.data(), kBlockSize);
+    juce::MidiBuffer midi;
+    plugin.processBlock(buffer, midi);
+
+    // Reference: identity routing, so output 2 + k is speaker k; Dry/Wet
+    // and Gain at their defaults
+    UpmixPipeline reference;
+    reference.prepare(kSampleRate, kBlockSize, layout);
+    juce::AudioBuffer<float> expected(numOutputChannels, kBlockSize);
+    {
+        juce::ScopedNoDenormals noDenormals;
+        reference.process(inputL.data(), inputR.data(), expected.getArrayOfWritePointers(),
+                          numOutputChannels, kBlockSize, layout, 1.0f, 0.0f);
+    }
+
+    auto carries = [&](int ch, int speaker) {
+        for (int i = 0; i < kBlockSize; ++i) {
+            if (std::abs(buffer.getSample(2 + ch, i) - expected.getSample(2 + speaker, i)) > 1e-6f)
+                return false;
+        }
+        return true;
+    };
+
+    // Channels that match exactly one speaker feed must not share it (some
+    // feeds, e.g. the two LFEs of 22.2, are identical and match several)
+    std::vector<int> owner(static_cast<size_t>(numSpeakers), -1);
+    for (int ch = 0; ch < wetSet.size(); ++ch) {
+        const auto type = wetSet.getTypeOfChannel(ch);
+        const auto typeName = juce::AudioChannelSet::getAbbreviatedChannelTypeName(type).toStdString();
+        std::vector<int> matches;
+        for (int speaker = 0; speaker < numSpeakers; ++speaker) {
+            if (carries(ch, speaker))
+                matches.push_back(speaker);
+        }
+        ASSERT_FALSE(matches.empty()) << "channel " << ch << " (" << typeName << ") carries no speaker feed";
+
+        const int speaker = expectedSpeaker(layout, type);
+        if (speaker >= 0)
+            EXPECT_TRUE(carries(ch, speaker)) << "channel " << ch << " (" << typeName << ")";
+        if (matches.size() == 1) {
+            auto& first = owner[static_cast<size_t>(matches[0])];
+            EXPECT_EQ(first, -1) << "channels " << first << " and " << ch << " carry speaker " << matches[0];
+            first = ch;
+        }
+    }
+    // Decoded feeds are not silent
+    EXPECT_GT(buffer.getRMSLevel(2, 0, kBlockSize), 0.0f);
+}
+
+TEST(PluginTest, DiscreteWetBusAcceptedOnlyWithOtherAuxBusesDisabled) {
+    auto plugin = std::make_unique<AudioPluginAudioProcessor>();
+
+    for (const auto& wet : discreteWetLayouts()) {
+        SCOPED_TRACE(wet.channelSet.getDescription().toStdString());
+
+        auto layouts = discreteWetBusesLayout(*plugin, wet.channelSet);
+        EXPECT_TRUE(plugin->isBusesLayoutSupported(layouts));
+
+        layouts.outputBuses.getReference(2) = juce::AudioChannelSet::stereo();
+        EXPECT_FALSE(plugin->isBusesLayoutSupported(layouts));
+    }
+
+    // A multichannel set that is no speaker layout stays rejected
+    EXPECT_FALSE(plugin->isBusesLayoutSupported(
+        discreteWetBusesLayout(*plugin, juce::AudioChannelSet::discreteChannels(6))));
+}
+
+TEST(PluginTest, DiscreteWetBusWritesSpeakerFeedsByChannelType) {
+    for (const auto& wet : discreteWetLayouts()) {
+        SCOPED_TRACE(wet.channelSet.getDescription().toStdString());
+        auto plugin = std::make_unique<AudioPluginAudioProcessor>();
+        ASSERT_TRUE(plugin->setBusesLayout(discreteWetBusesLayout(*plugin, wet.channelSet)));
+        expectWetChannelsCarryTheirSpeakers(*plugin, wet.layout);
+    }
+}
+
+TEST(PluginTest, DiscreteWetBusOverridesLayoutParameter) {
+    auto plugin = std::make_unique<AudioPluginAudioProcessor>();
+    auto* layoutParam = plugin->getAPVTS().getParameter(ParamID::kLayout);
+    layoutParam->setValueNotifyingHost(layoutParam->convertTo0to1(
+        static_cast<float>(SpeakerLayout::Stereo)));
+    ASSERT_EQ(static_cast<int>(plugin->getAPVTS().getRawParameterValue(ParamID::kLayout)->load()),
+              static_cast<int>(SpeakerLayout::Stereo));
+
+    for (const auto& wet : discreteWetLayouts()) {
+        if (wet.layout != SpeakerLayout::Surround222)
+            continue;
+        ASSERT_TRUE(plugin->setBusesLayout(discreteWetBusesLayout(*plugin, wet.channelSet)));
+        expectWetChannelsCarryTheirSpeakers(*plugin, SpeakerLayout::Surround222);
+    }
+}